@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include "../src/vmath/vmath.h"
+
+#define SAMPLES 400000
+#define CHUNK 4096
+#define POW 12
+
+struct Check {
+    const char *name;
+    int function;
+    double from;
+    double to;
+    char logarithmic;
+    double bound[2];
+    char relative[2];
+};
+
+static long double (*const references[12])(long double) = {
+    sqrtl,
+    expl,
+    exp2l,
+    logl,
+    log10l,
+    log2l,
+    sinl,
+    cosl,
+    tanl,
+    sinhl,
+    coshl,
+    tanhl
+};
+
+/*
+ * Bounds match the table in the README: ULPs of the long double reference
+ * rounded to double, or relative error where `relative` is set.
+ */
+static const struct Check checks[] = {
+    { "sqrt", 0, 0x1p-1020, 0x1p1020, 1, { 0.5, 0.5 }, { 0, 0 } },
+    { "exp", 1, -745, 709, 0, { 1, 3e-13 }, { 0, 1 } },
+    { "exp2", 2, -1074, 1023, 0, { 1, 3e-13 }, { 0, 1 } },
+    { "log", 3, 0x1p-1020, 0x1p1020, 1, { 0.9, 1.5e-12 }, { 0, 1 } },
+    { "log near 1", 3, 0.5, 2, 0, { 0.9, 1.5e-12 }, { 0, 1 } },
+    { "log10", 4, 0x1p-1020, 0x1p1020, 1, { 0.9, 1.5e-12 }, { 0, 1 } },
+    { "log2", 5, 0x1p-1020, 0x1p1020, 1, { 0.9, 1.5e-12 }, { 0, 1 } },
+    { "sin", 6, -10, 10, 0, { 0.8, 4.3 }, { 0, 0 } },
+    { "sin wide", 6, -0x1p20, 0x1p20, 0, { 0.8, 4.3 }, { 0, 0 } },
+    { "cos", 7, -10, 10, 0, { 0.8, 4.3 }, { 0, 0 } },
+    { "cos wide", 7, -0x1p20, 0x1p20, 0, { 0.8, 4.3 }, { 0, 0 } },
+    { "tan", 8, -10, 10, 0, { 1, 3.4 }, { 0, 0 } },
+    { "tan wide", 8, -0x1p20, 0x1p20, 0, { 1, 3.4 }, { 0, 0 } },
+    { "sinh", 9, -710, 710, 0, { 1, 9e-13 }, { 0, 1 } },
+    { "sinh small", 9, -1, 1, 0, { 1, 9e-13 }, { 0, 1 } },
+    { "cosh", 10, -710, 710, 0, { 1, 9e-13 }, { 0, 1 } },
+    { "tanh", 11, -20, 20, 0, { 1, 9e-13 }, { 0, 1 } },
+    { "pow", POW, 0x1p-30, 0x1p30, 1, { 1, 4e-13 }, { 0, 1 } }
+};
+
+static double ulp(double x) {
+    int exponent = ilogb(x);
+    return ldexp(1, (exponent < DBL_MIN_EXP - 1 ? DBL_MIN_EXP - 1 :
+                     exponent) - DBL_MANT_DIG + 1);
+}
+
+static double sample(const struct Check *check) {
+    double u = rand() / (RAND_MAX + 1.0);
+    if (check->logarithmic) {
+        return exp2(log2(check->from) +
+                    u * (log2(check->to) - log2(check->from)));
+    }
+    return check->from + u * (check->to - check->from);
+}
+
+static double error(long double reference, double value, char relative) {
+    double rounded = reference;
+    if (isnan(value) || isnan(rounded)) {
+        return isnan(value) == isnan(rounded) ? 0 : INFINITY;
+    }
+    if (isinf(rounded) || rounded == 0) {
+        return value == rounded ? 0 : INFINITY;
+    }
+    if (relative) {
+        return fabsl(value - reference) / fmax(fabs(rounded), DBL_MIN);
+    }
+    return fabsl(value - reference) / ulp(rounded);
+}
+
+static int run_check(const struct Check *check) {
+    static double xs[CHUNK], ys[CHUNK], zs[CHUNK];
+    static long double references_out[CHUNK];
+    double worst[2] = { 0, 0 }, e, scalar;
+    int mismatches = 0, failures = 0;
+    srand(1);
+    for (int done = 0; done < SAMPLES; done += CHUNK) {
+        for (int i = 0; i < CHUNK; ++i) {
+            xs[i] = sample(check);
+            if (check->function == POW) {
+                ys[i] = -30 + 60 * (rand() / (RAND_MAX + 1.0));
+                references_out[i] = powl(xs[i], ys[i]);
+            } else {
+                references_out[i] = references[check->function](xs[i]);
+            }
+        }
+        for (int m = MATH_ULP; m <= MATH_FAST; ++m) {
+            if (check->function == POW) {
+                vmath_pow[m](xs, ys, zs, CHUNK);
+            } else {
+                vmath_unary[m][check->function](xs, zs, CHUNK);
+            }
+            for (int i = 0; i < CHUNK; ++i) {
+                e = error(references_out[i], zs[i], check->relative[m - 1]);
+                worst[m - 1] = fmax(worst[m - 1], e);
+                scalar = check->function == POW ?
+                         vmath_scalar_pow[m](xs[i], ys[i]) :
+                         vmath_scalar[m][check->function](xs[i]);
+                if (memcmp(&scalar, zs + i, sizeof(double))) {
+                    ++mismatches;
+                }
+            }
+        }
+    }
+    printf("%-12s", check->name);
+    for (int m = 0; m < 2; ++m) {
+        printf(" %10.3g %-8s", worst[m],
+               check->relative[m] ? "relative" : "ULP");
+        if (!(worst[m] <= check->bound[m])) {
+            ++failures;
+        }
+    }
+    printf("%s\n", failures ? " EXCEEDS BOUND" : "");
+    if (mismatches) {
+        printf("%-12s %d scalar results differ from batch\n",
+               check->name, mismatches);
+    }
+    return failures + (mismatches != 0);
+}
+
+int main(void) {
+    int failures = 0;
+    printf("%-12s %19s %19s  (%s, %d samples)\n",
+           "function", "ulp", "fast", vmath_isa, SAMPLES);
+    for (size_t i = 0; i < sizeof(checks) / sizeof(checks[0]); ++i) {
+        failures += run_check(checks + i);
+    }
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,280 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include "../src/core/core.h"
+#include "../src/cli/cli.h"
+#include "../src/pool/pool.h"
+#include "../src/vmath/vmath.h"
+
+#define SAMPLES 4096
+#define MIN_SECONDS 0.1
+#define REPEATS 3
+#define INTEGRATE_CHUNKS 10000000UL
+
+struct Case {
+    const char *name;
+    const char *expression;
+    double from;
+    double to;
+};
+
+struct Result {
+    char name[64];
+    double scalar;
+    double batch;
+    double integrate;
+};
+
+static const struct Case cases[3] = {
+    {
+        "rational",
+        "x 3 ^ 2 x 2 ^ * - x 5 * + 1 - x 2 ^ 1 + /",
+        -2, 2
+    },
+    {
+        "transcendental",
+        "x sin x cos * x exp log + x sqrt x tanh * + x log2 x cosh / +",
+        0.1, 4
+    },
+    {
+        "deep",
+        "x 1 + x 2 + x 3 + x 4 + x 5 + x 6 + x 7 + x 8 + "
+        "x 9 + x 10 + x 11 + x 12 + x 13 + x 14 + x 15 + x 16 + "
+        "* / * / * / * / * / * / * / *",
+        -1, 1
+    }
+};
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double scalar_rate(const double *xs) {
+    unsigned long count = 0;
+    double sink = 0, y;
+    double start = now(), elapsed;
+    do {
+        for (int i = 0; i < SAMPLES; ++i) {
+            core_evaluate(xs[i], &y);
+            sink += y;
+        }
+        count += SAMPLES;
+        elapsed = now() - start;
+    } while (elapsed < MIN_SECONDS);
+    if (sink == 42) {
+        fputc(' ', stderr);
+    }
+    return count / elapsed;
+}
+
+static double batch_rate(const double *xs, double *ys) {
+    unsigned long count = 0;
+    double start = now(), elapsed;
+    do {
+        core_evaluate_batch(xs, ys, SAMPLES);
+        count += SAMPLES;
+        elapsed = now() - start;
+    } while (elapsed < MIN_SECONDS);
+    return count / elapsed;
+}
+
+static double integrate_time(const struct Case *bench_case) {
+    double result;
+    double start = now();
+    core_integrate(bench_case->from, bench_case->to, INTEGRATE_CHUNKS, &result);
+    return now() - start;
+}
+
+static double best(double a, double b, char faster_is_larger) {
+    return (a > b) == faster_is_larger ? a : b;
+}
+
+static int run_case(const struct Case *bench_case,
+                    const char *backend,
+                    struct Result *result) {
+    double xs[SAMPLES], ys[SAMPLES];
+    double step = (bench_case->to - bench_case->from) / SAMPLES;
+    if (cli_parse(bench_case->expression, expression) || core_compile()) {
+        fprintf(stderr, "Invalid benchmark %s\n", bench_case->name);
+        return 1;
+    }
+    for (int i = 0; i < SAMPLES; ++i) {
+        xs[i] = bench_case->from + i * step;
+    }
+    snprintf(result->name, 64, "%s/%s", bench_case->name, backend);
+    result->scalar = 0;
+    result->batch = 0;
+    result->integrate = 1e300;
+    for (int i = 0; i < REPEATS; ++i) {
+        result->scalar = best(result->scalar, scalar_rate(xs), 1);
+        result->batch = best(result->batch, batch_rate(xs, ys), 1);
+        result->integrate = best(result->integrate,
+                                 integrate_time(bench_case), 0);
+    }
+    printf("%-28s %12.4g eval/s %12.4g batch eval/s %8.4f s integrate\n",
+           result->name, result->scalar, result->batch, result->integrate);
+    return 0;
+}
+
+static int write_results(const char *path, const struct Result *results, int n) {
+    FILE *fout = fopen(path, "w");
+    if (!fout) {
+        fprintf(stderr, "Cannot write %s\n", path);
+        return 1;
+    }
+    fprintf(fout, "{\n    \"chunks\": %lu,\n    \"cases\": [\n", INTEGRATE_CHUNKS);
+    for (int i = 0; i < n; ++i) {
+        fprintf(fout,
+                "        {\n"
+                "            \"name\": \"%s\",\n"
+                "            \"evaluations_per_second\": %.6g,\n"
+                "            \"batch_evaluations_per_second\": %.6g,\n"
+                "            \"integrate_seconds\": %.6g\n"
+                "        }%s\n",
+                results[i].name, results[i].scalar,
+                results[i].batch, results[i].integrate,
+                i + 1 < n ? "," : "");
+    }
+    fputs("    ]\n}\n", fout);
+    return fclose(fout) != 0;
+}
+
+static char *read_text(const char *path) {
+    FILE *fin = fopen(path, "r");
+    char *text;
+    long size;
+    if (!fin) {
+        return NULL;
+    }
+    fseek(fin, 0, SEEK_END);
+    size = ftell(fin);
+    fseek(fin, 0, SEEK_SET);
+    text = malloc(size + 1);
+    if (text) {
+        text[fread(text, 1, size, fin)] = 0;
+    }
+    fclose(fin);
+    return text;
+}
+
+static int find_value(const char *text,
+                      const char *name,
+                      const char *key,
+                      double *out) {
+    char pattern[96];
+    const char *object, *end, *field;
+    snprintf(pattern, sizeof(pattern), "\"name\": \"%s\"", name);
+    object = strstr(text, pattern);
+    if (!object) {
+        return 1;
+    }
+    end = strchr(object, '}');
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    field = strstr(object, pattern);
+    if (!field || (end && field > end)) {
+        return 1;
+    }
+    *out = strtod(field + strlen(pattern), NULL);
+    return 0;
+}
+
+static int compare(const char *path,
+                   const struct Result *results,
+                   int n,
+                   double threshold) {
+    char *text = read_text(path);
+    double base;
+    int slower = 0;
+    if (!text) {
+        fprintf(stderr, "No baseline at %s\n", path);
+        return 0;
+    }
+    for (int i = 0; i < n; ++i) {
+        if (!find_value(text, results[i].name,
+                        "evaluations_per_second", &base) &&
+            results[i].scalar < base * (1 - threshold)) {
+            printf("SLOWER %s evaluations: %.4g vs %.4g\n",
+                   results[i].name, results[i].scalar, base);
+            ++slower;
+        }
+        if (!find_value(text, results[i].name,
+                        "batch_evaluations_per_second", &base) &&
+            results[i].batch < base * (1 - threshold)) {
+            printf("SLOWER %s batch evaluations: %.4g vs %.4g\n",
+                   results[i].name, results[i].batch, base);
+            ++slower;
+        }
+        if (!find_value(text, results[i].name,
+                        "integrate_seconds", &base) &&
+            results[i].integrate > base * (1 + threshold)) {
+            printf("SLOWER %s integrate: %.4g s vs %.4g s\n",
+                   results[i].name, results[i].integrate, base);
+            ++slower;
+        }
+    }
+    free(text);
+    if (slower) {
+        printf("%d regression(s) beyond %.0f%%\n", slower, threshold * 100);
+    }
+    return slower;
+}
+
+int main(int argc, char **argv) {
+    static const char *backends[2] = { "interpreter", "jit" };
+    static const char *tiers[3] = { "strict", "ulp", "fast" };
+    struct Result results[8];
+    const char *output = "bench/results.json";
+    const char *baseline = NULL;
+    double threshold = 0.2;
+    int n = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "o:b:s:j:")) != -1) {
+        switch (opt) {
+        case 'o':
+            output = optarg;
+            break;
+        case 'b':
+            baseline = optarg;
+            break;
+        case 's':
+            threshold = atof(optarg);
+            break;
+        case 'j':
+            default_context.threads = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr,
+                    "Usage: %s [-o output] [-b baseline] [-s threshold] "
+                    "[-j threads]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    default_context.memo.limit = 0;
+    for (int b = 0; b < 2; ++b) {
+        default_context.use_jit = b;
+        for (int i = 0; i < 3; ++i, ++n) {
+            if (run_case(cases + i, backends[b], results + n)) {
+                return 1;
+            }
+        }
+    }
+    for (int m = MATH_ULP; m <= MATH_FAST; ++m, ++n) {
+        default_context.math = m;
+        if (run_case(cases + 1, tiers[m], results + n)) {
+            return 1;
+        }
+    }
+    pool_finalize();
+    if (write_results(output, results, n)) {
+        return 1;
+    }
+    if (baseline && compare(baseline, results, n, threshold)) {
+        return 2;
+    }
+    return 0;
+}
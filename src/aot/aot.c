@@ -0,0 +1,272 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dlfcn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <cpuid.h>
+#include "../core/core.h"
+#include "aot.h"
+
+#define AOT_VERSION "fc-aot-3"
+#define AOT_COMPILER "gcc"
+#define AOT_FLAGS "-O3", "-march=native", "-ffp-contract=off", "-shared", "-fPIC"
+
+static uint64_t hash_bytes(uint64_t hash, const void *data, size_t size) {
+    const unsigned char *iter = data;
+    for (size_t i = 0; i < size; ++i, ++iter) {
+        hash ^= *iter;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static pid_t spawn(char *const argv[], int out) {
+    int fd;
+    pid_t pid = fork();
+    if (pid) {
+        return pid;
+    }
+    fd = open("/dev/null", O_WRONLY);
+    if (fd >= 0) {
+        dup2(out >= 0 ? out : fd, STDOUT_FILENO);
+        dup2(fd, STDERR_FILENO);
+    }
+    execvp(argv[0], argv);
+    _exit(127);
+}
+
+static int finish(pid_t pid) {
+    int status;
+    if (pid < 0 || waitpid(pid, &status, 0) < 0) {
+        return 1;
+    }
+    return !WIFEXITED(status) || WEXITSTATUS(status);
+}
+
+/* The objects are built with -march=native, so the key covers the
+ * compiler that built them and the processor they were tuned for. */
+static uint64_t hash_host(uint64_t hash) {
+    static char version[512];
+    static ssize_t length = -1;
+    char *argv[] = { AOT_COMPILER, "--version", NULL };
+    unsigned int registers[4][4] = { { 0 } };
+    int fds[2];
+    ssize_t got;
+    pid_t pid;
+    if (length < 0) {
+        length = 0;
+        if (!pipe(fds)) {
+            pid = spawn(argv, fds[1]);
+            close(fds[1]);
+            while (pid > 0 && length < (ssize_t)sizeof(version) &&
+                   (got = read(fds[0], version + length,
+                               sizeof(version) - length)) > 0) {
+                length += got;
+            }
+            close(fds[0]);
+            finish(pid);
+        }
+    }
+    hash = hash_bytes(hash, version, length);
+    __get_cpuid(0, registers[0], registers[0] + 1,
+                registers[0] + 2, registers[0] + 3);
+    __get_cpuid(1, registers[1], registers[1] + 1,
+                registers[1] + 2, registers[1] + 3);
+    __get_cpuid_count(7, 0, registers[2], registers[2] + 1,
+                      registers[2] + 2, registers[2] + 3);
+    __get_cpuid(0x80000001, registers[3], registers[3] + 1,
+                registers[3] + 2, registers[3] + 3);
+    /* Leaf 1 ebx holds the APIC id of whichever core we run on. */
+    registers[1][1] = 0;
+    return hash_bytes(hash, registers, sizeof(registers));
+}
+
+static uint64_t hash_program(const struct Program *program) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    size_t length = program->code_length;
+    hash = hash_bytes(hash, AOT_VERSION, sizeof(AOT_VERSION));
+    hash = hash_host(hash);
+    hash = hash_bytes(hash, program->code, length);
+    hash = hash_bytes(hash, program->dst, length);
+    hash = hash_bytes(hash, program->a, length);
+    hash = hash_bytes(hash, program->b, length);
+    hash = hash_bytes(hash, &program->result, 1);
+    return hash_bytes(hash,
+                      program->pool + 1,
+                      (program->pinned - 1) * sizeof(double));
+}
+
+static int cache_directory(char *out, size_t size) {
+    const char *base = getenv("XDG_CACHE_HOME");
+    char parent[PATH_MAX];
+    if (base && *base) {
+        snprintf(parent, PATH_MAX, "%s", base);
+    } else {
+        base = getenv("HOME");
+        if (!base || !*base) {
+            return 1;
+        }
+        snprintf(parent, PATH_MAX, "%s/.cache", base);
+    }
+    mkdir(parent, 0755);
+    if (snprintf(out, size, "%s/fc", parent) >= (int)size) {
+        return 1;
+    }
+    if (mkdir(out, 0755) && access(out, W_OK)) {
+        return 1;
+    }
+    return 0;
+}
+
+static void generate_number(FILE *fout, double number) {
+    if (isnan(number)) {
+        fputs("NAN", fout);
+    } else if (isinf(number)) {
+        fprintf(fout, "%sINFINITY", number < 0 ? "-" : "");
+    } else {
+        fprintf(fout, "%a", number);
+    }
+}
+
+static int generate(int fd, const struct Program *program) {
+    FILE *fout = fdopen(fd, "w");
+    unsigned char op;
+    if (!fout) {
+        close(fd);
+        return 1;
+    }
+    fputs("#include <stddef.h>\n#include <math.h>\n\n", fout);
+    fputs("static inline double body(double x) {\n", fout);
+    fputs("    double r0 = x;\n", fout);
+    for (unsigned char i = 1; i < program->pinned; ++i) {
+        fprintf(fout, "    const double r%u = ", i);
+        generate_number(fout, program->pool[i]);
+        fputs(";\n", fout);
+    }
+    for (unsigned char i = program->pinned; i < program->registers; ++i) {
+        fprintf(fout, "    double r%u;\n", i);
+    }
+    for (unsigned char i = 0; i < program->code_length; ++i) {
+        op = program->code[i];
+        if (op == OP_POW) {
+            fprintf(fout,
+                    "    r%u = pow(r%u, r%u);\n",
+                    program->dst[i], program->a[i], program->b[i]);
+        } else if (op >= OP_BINARY) {
+            fprintf(fout,
+                    "    r%u = r%u %s r%u;\n",
+                    program->dst[i], program->a[i],
+                    binary_names[op - OP_BINARY],
+                    program->b[i]);
+        } else {
+            fprintf(fout,
+                    "    r%u = %s(r%u);\n",
+                    program->dst[i],
+                    unary_names[op - OP_UNARY],
+                    program->a[i]);
+        }
+    }
+    fprintf(fout, "    return r%u;\n}\n\n", program->result);
+    fputs("double fc_evaluate(double x) {\n"
+          "    return body(x);\n"
+          "}\n\n"
+          "void fc_evaluate_batch(const double *restrict in,\n"
+          "                       double *restrict out,\n"
+          "                       size_t n) {\n"
+          "    for (size_t i = 0; i < n; ++i) {\n"
+          "        out[i] = body(in[i]);\n"
+          "    }\n"
+          "}\n",
+          fout);
+    return fclose(fout) != 0;
+}
+
+static int compile(const char *source, const char *object) {
+    char *argv[] = {
+        AOT_COMPILER, AOT_FLAGS, "-o", (char *)object, (char *)source, "-lm",
+        NULL
+    };
+    return finish(spawn(argv, -1));
+}
+
+int aot_compile(struct Aot *aot, const struct Program *program) {
+    char directory[PATH_MAX];
+    char source[PATH_MAX + 32];
+    char temp[PATH_MAX + 32];
+    char object[PATH_MAX + 32];
+    uint64_t hash;
+    int fd, ret;
+    if (!aot) {
+        return 1;
+    }
+    aot_release(aot);
+    if (program->status) {
+        return 2;
+    }
+    if (cache_directory(directory, PATH_MAX)) {
+        return 3;
+    }
+    hash = hash_program(program);
+    snprintf(object, sizeof(object),
+             "%s/%016llx.so", directory, (unsigned long long)hash);
+    if (access(object, R_OK)) {
+        snprintf(source, sizeof(source),
+                 "%s/%016llx.XXXXXX.c", directory, (unsigned long long)hash);
+        snprintf(temp, sizeof(temp),
+                 "%s/%016llx.XXXXXX.so", directory, (unsigned long long)hash);
+        fd = mkstemps(source, 2);
+        if (fd < 0) {
+            return 3;
+        }
+        if (generate(fd, program)) {
+            remove(source);
+            return 3;
+        }
+        fd = mkstemps(temp, 3);
+        if (fd < 0) {
+            remove(source);
+            return 3;
+        }
+        fchmod(fd, 0755);
+        close(fd);
+        ret = compile(source, temp);
+        remove(source);
+        if (ret) {
+            remove(temp);
+            return 4;
+        }
+        if (rename(temp, object)) {
+            remove(temp);
+            return 3;
+        }
+    }
+    aot->handle = dlopen(object, RTLD_NOW | RTLD_LOCAL);
+    if (!aot->handle) {
+        return 5;
+    }
+    *(void **)&aot->function = dlsym(aot->handle, "fc_evaluate");
+    *(void **)&aot->batch = dlsym(aot->handle, "fc_evaluate_batch");
+    if (!aot->function || !aot->batch) {
+        aot_release(aot);
+        return 5;
+    }
+    return 0;
+}
+
+void aot_release(struct Aot *aot) {
+    if (!aot) {
+        return;
+    }
+    if (aot->handle) {
+        dlclose(aot->handle);
+    }
+    aot->handle = NULL;
+    aot->function = NULL;
+    aot->batch = NULL;
+}
@@ -0,0 +1,17 @@
+#ifndef _AOT_H_
+#define _AOT_H_
+
+#include <stddef.h>
+
+struct Program;
+
+struct Aot {
+    void *handle;
+    double (*function)(double);
+    void (*batch)(const double *, double *, size_t);
+};
+
+int aot_compile(struct Aot *aot, const struct Program *program);
+void aot_release(struct Aot *aot);
+
+#endif
@@ -0,0 +1,249 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "chebyshev.h"
+
+#pragma GCC optimize("fp-contract=off")
+
+#define CHECKS 1024
+#define LANES 64
+
+static double series(const double *c, int degree, double t) {
+    double b0, b1 = 0, b2 = 0;
+    for (int j = degree; j > 0; --j) {
+        b0 = 2 * t * b1 - b2 + c[j];
+        b2 = b1;
+        b1 = b0;
+    }
+    return t * b1 - b2 + c[0];
+}
+
+static void transform(const double *values,
+                      double *cosines,
+                      double *c,
+                      int n) {
+    double sum;
+    for (int m = 0; m < 2 * n; ++m) {
+        cosines[m] = cos(M_PI * m / n);
+    }
+    for (int j = 0; j <= n; ++j) {
+        sum = (values[0] + values[n] * cosines[(long)j * n % (2 * n)]) / 2;
+        for (int k = 1; k < n; ++k) {
+            sum += values[k] * cosines[(long)j * k % (2 * n)];
+        }
+        c[j] = 2 * sum / n;
+    }
+    c[0] /= 2;
+    c[n] /= 2;
+}
+
+static char converged(const double *c, int n, int *degree) {
+    double scale = 0, tail = 0;
+    int length = n / 8 > 2 ? n / 8 : 2;
+    for (int j = 0; j <= n; ++j) {
+        scale = fmax(scale, fabs(c[j]));
+    }
+    for (int j = n - length + 1; j <= n; ++j) {
+        tail = fmax(tail, fabs(c[j]));
+    }
+    for (*degree = n; *degree > 0 &&
+         fabs(c[*degree]) <= CHEBYSHEV_TOLERANCE * scale; --*degree);
+    return tail <= CHEBYSHEV_TOLERANCE * scale;
+}
+
+static void differentiate(const double *c, int degree, double scale,
+                          double *d) {
+    memset(d, 0, (degree + 1) * sizeof(double));
+    for (int k = degree; k > 0; --k) {
+        d[k - 1] = (k + 1 <= degree ? d[k + 1] : 0) + 2 * k * c[k];
+    }
+    d[0] /= 2;
+    for (int k = 0; k < degree; ++k) {
+        d[k] *= scale;
+    }
+}
+
+static void integrate(const double *c, int degree, double scale, double *s) {
+    s[0] = 0;
+    for (int k = 1; k <= degree + 1; ++k) {
+        s[k] = ((k - 1 <= degree ? c[k - 1] : 0) * (k == 1 ? 2 : 1) -
+                (k + 1 <= degree ? c[k + 1] : 0)) / (2 * k) * scale;
+    }
+}
+
+static int allocate(struct Chebyshev *chebyshev, int degree) {
+    chebyshev->coefficients = malloc((degree + 1) * sizeof(double));
+    chebyshev->first = malloc((degree + 1) * sizeof(double));
+    chebyshev->second = malloc((degree + 1) * sizeof(double));
+    chebyshev->integral = malloc((degree + 2) * sizeof(double));
+    if (!chebyshev->coefficients || !chebyshev->first ||
+        !chebyshev->second || !chebyshev->integral) {
+        chebyshev_release(chebyshev);
+        return 1;
+    }
+    return 0;
+}
+
+int chebyshev_fit(struct Chebyshev *chebyshev,
+                  Sampler sample,
+                  void *arg,
+                  double from,
+                  double to) {
+    double mid = (from + to) / 2, half = (to - from) / 2;
+    double *values, *points, *cosines, *c, *ys;
+    double error = 0, scale = 0;
+    int n = 16, degree = 0, ret = 1;
+    char done;
+    chebyshev_release(chebyshev);
+    if (!(from < to)) {
+        return 2;
+    }
+    values = malloc((CHEBYSHEV_DEGREE + 1) * sizeof(double));
+    points = malloc((CHEBYSHEV_DEGREE + 1) * sizeof(double));
+    cosines = malloc(2 * CHEBYSHEV_DEGREE * sizeof(double));
+    c = malloc((CHEBYSHEV_DEGREE + 1) * sizeof(double));
+    ys = malloc(CHECKS * sizeof(double));
+    if (!values || !points || !cosines || !c || !ys) {
+        goto cleanup;
+    }
+    for (int k = 0; k <= n; ++k) {
+        points[k] = mid + half * cos(M_PI * k / n);
+    }
+    if (sample(arg, points, values, n + 1)) {
+        goto cleanup;
+    }
+    for (;;) {
+        for (int k = 0; k <= n; ++k) {
+            if (!isfinite(values[k])) {
+                ret = 3;
+                goto cleanup;
+            }
+        }
+        transform(values, cosines, c, n);
+        done = converged(c, n, &degree);
+        if (done || n == CHEBYSHEV_DEGREE) {
+            break;
+        }
+        for (int k = n; k >= 0; --k) {
+            values[2 * k] = values[k];
+        }
+        for (int k = 0; k < n; ++k) {
+            points[k] = mid + half * cos(M_PI * (2 * k + 1) / (2 * n));
+        }
+        if (sample(arg, points, c, n)) {
+            goto cleanup;
+        }
+        for (int k = 0; k < n; ++k) {
+            values[2 * k + 1] = c[k];
+        }
+        n *= 2;
+    }
+    if (!done) {
+        ret = 4;
+        goto cleanup;
+    }
+    for (int i = 0; i < CHECKS; ++i) {
+        points[i] = from + (i + 0.5) / CHECKS * (to - from);
+    }
+    if (sample(arg, points, ys, CHECKS)) {
+        goto cleanup;
+    }
+    for (int i = 0; i < CHECKS; ++i) {
+        scale = fmax(scale, fabs(ys[i]));
+        error = fmax(error, fabs(ys[i] - series(c, degree,
+                                                (points[i] - mid) / half)));
+    }
+    if (!(error <= CHEBYSHEV_ACCURACY * scale)) {
+        ret = 5;
+        goto cleanup;
+    }
+    if (allocate(chebyshev, degree)) {
+        goto cleanup;
+    }
+    memcpy(chebyshev->coefficients, c, (degree + 1) * sizeof(double));
+    differentiate(c, degree, 1 / half, chebyshev->first);
+    differentiate(chebyshev->first, degree, 1 / half, chebyshev->second);
+    integrate(c, degree, half, chebyshev->integral);
+    chebyshev->from = from;
+    chebyshev->to = to;
+    chebyshev->degree = degree;
+    chebyshev->error = error;
+    ret = 0;
+cleanup:
+    free(values);
+    free(points);
+    free(cosines);
+    free(c);
+    free(ys);
+    return ret;
+}
+
+double chebyshev_evaluate(const struct Chebyshev *chebyshev, double x) {
+    double scale = 2 / (chebyshev->to - chebyshev->from);
+    double shift = (chebyshev->from + chebyshev->to) / 2;
+    return series(chebyshev->coefficients, chebyshev->degree,
+                  (x - shift) * scale);
+}
+
+__attribute__((target_clones("avx512f", "avx2", "default")))
+void chebyshev_evaluate_batch(const struct Chebyshev *chebyshev,
+                              const double *in,
+                              double *out,
+                              size_t n) {
+    const double *c = chebyshev->coefficients;
+    double scale = 2 / (chebyshev->to - chebyshev->from);
+    double shift = (chebyshev->from + chebyshev->to) / 2;
+    double t[LANES], b0, b1[LANES], b2[LANES];
+    size_t len;
+    for (size_t base = 0; base < n; base += len, in += len, out += len) {
+        len = n - base < LANES ? n - base : LANES;
+        for (size_t i = 0; i < LANES; ++i) {
+            t[i] = i < len ? (in[i] - shift) * scale : 0;
+            b1[i] = 0;
+            b2[i] = 0;
+        }
+        for (int j = chebyshev->degree; j > 0; --j) {
+            for (size_t i = 0; i < LANES; ++i) {
+                b0 = 2 * t[i] * b1[i] - b2[i] + c[j];
+                b2[i] = b1[i];
+                b1[i] = b0;
+            }
+        }
+        for (size_t i = 0; i < len; ++i) {
+            out[i] = t[i] * b1[i] - b2[i] + c[0];
+        }
+    }
+}
+
+void chebyshev_derivative(const struct Chebyshev *chebyshev,
+                          double x,
+                          struct Dual *out) {
+    double scale = 2 / (chebyshev->to - chebyshev->from);
+    double t = (x - (chebyshev->from + chebyshev->to) / 2) * scale;
+    out->value = series(chebyshev->coefficients, chebyshev->degree, t);
+    out->first = series(chebyshev->first, chebyshev->degree, t);
+    out->second = series(chebyshev->second, chebyshev->degree, t);
+}
+
+double chebyshev_integral(const struct Chebyshev *chebyshev,
+                          double from,
+                          double to) {
+    double scale = 2 / (chebyshev->to - chebyshev->from);
+    double shift = (chebyshev->from + chebyshev->to) / 2;
+    return series(chebyshev->integral, chebyshev->degree + 1,
+                  (to - shift) * scale) -
+           series(chebyshev->integral, chebyshev->degree + 1,
+                  (from - shift) * scale);
+}
+
+void chebyshev_release(struct Chebyshev *chebyshev) {
+    free(chebyshev->coefficients);
+    free(chebyshev->first);
+    free(chebyshev->second);
+    free(chebyshev->integral);
+    chebyshev->coefficients = NULL;
+    chebyshev->first = NULL;
+    chebyshev->second = NULL;
+    chebyshev->integral = NULL;
+    chebyshev->degree = 0;
+}
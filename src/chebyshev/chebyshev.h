@@ -0,0 +1,42 @@
+#ifndef _CHEBYSHEV_H_
+#define _CHEBYSHEV_H_
+
+#include <stddef.h>
+#include "../dual/dual.h"
+
+#define CHEBYSHEV_DEGREE 4096
+#define CHEBYSHEV_TOLERANCE 1e-14
+#define CHEBYSHEV_ACCURACY 1e-10
+
+typedef int (*Sampler)(void *arg, const double *in, double *out, size_t n);
+
+struct Chebyshev {
+    double from;
+    double to;
+    double *coefficients;
+    double *first;
+    double *second;
+    double *integral;
+    int degree;
+    double error;
+};
+
+int chebyshev_fit(struct Chebyshev *chebyshev,
+                  Sampler sample,
+                  void *arg,
+                  double from,
+                  double to);
+double chebyshev_evaluate(const struct Chebyshev *chebyshev, double x);
+void chebyshev_evaluate_batch(const struct Chebyshev *chebyshev,
+                              const double *in,
+                              double *out,
+                              size_t n);
+void chebyshev_derivative(const struct Chebyshev *chebyshev,
+                          double x,
+                          struct Dual *out);
+double chebyshev_integral(const struct Chebyshev *chebyshev,
+                          double from,
+                          double to);
+void chebyshev_release(struct Chebyshev *chebyshev);
+
+#endif
@@ -0,0 +1,858 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <stdint.h>
+#include <math.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "cli.h"
+#include "../vmath/vmath.h"
+#include "../precision/precision.h"
+#include "../solve/solve.h"
+
+#define IO_SIZE (1 << 20)
+#define VALUES 4096
+
+static char tabulate;
+static double tabulate_from, tabulate_to;
+
+static char *read_file(const char *path) {
+    FILE *fin = fopen(path, "r");
+    char *text;
+    long size;
+    if (!fin) {
+        return NULL;
+    }
+    fseek(fin, 0, SEEK_END);
+    size = ftell(fin);
+    fseek(fin, 0, SEEK_SET);
+    text = malloc(size + 1);
+    if (text) {
+        text[fread(text, 1, size, fin)] = 0;
+    }
+    fclose(fin);
+    return text;
+}
+
+static int lookup(const char *token, const char **names, int n) {
+    for (int i = 0; i < n; ++i) {
+        if (!strcmp(token, names[i])) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int cli_parse(const char *text, struct Symbol *expression) {
+    char token[64];
+    const char *iter = text;
+    char *end;
+    int length;
+    int index;
+    struct Symbol *symbol = expression;
+    memset(expression, 0, 100 * sizeof(struct Symbol));
+    for (;; ++symbol) {
+        for (; isspace((unsigned char)*iter); ++iter);
+        if (!*iter) {
+            return 0;
+        }
+        for (length = 0;
+             iter[length] && !isspace((unsigned char)iter[length]);
+             ++length);
+        if (length >= 64 || symbol == expression + 100) {
+            return 1;
+        }
+        memcpy(token, iter, length);
+        token[length] = 0;
+        iter += length;
+        if (!strcasecmp(token, "x")) {
+            symbol->type = INPUT;
+        } else if (!strcasecmp(token, "pi")) {
+            symbol->type = NUMBER;
+            symbol->data.number = pi;
+        } else if ((index = lookup(token, unary_names, 12)) >= 0) {
+            symbol->type = UNARY;
+            symbol->data.unary = index;
+        } else if ((index = lookup(token, binary_names, 5)) >= 0) {
+            symbol->type = BINARY;
+            symbol->data.binary = index;
+        } else {
+            symbol->type = NUMBER;
+            symbol->data.number = strtod(token, &end);
+            if (*end) {
+                return 2;
+            }
+        }
+    }
+}
+
+static int match(const char *name, const char **names, int count) {
+    const char *a, *b;
+    for (int i = 0; i < count; ++i) {
+        for (a = name, b = names[i]; *a || *b; ++a, ++b) {
+            if (*b == ' ') {
+                ++b;
+            }
+            if (tolower((unsigned char)*a) != tolower((unsigned char)*b)) {
+                break;
+            }
+        }
+        if (!*a && !*b) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int cli_rule(const char *name) {
+    return match(name, rule_names, 8);
+}
+
+int cli_math(const char *name) {
+    return match(name, math_names, 3);
+}
+
+int cli_precision(const char *name) {
+    return match(name, precision_names, 3);
+}
+
+int cli_tabulate(const char *range) {
+    char *end;
+    tabulate_from = strtod(range, &end);
+    if (end == range || *end != ',') {
+        return 1;
+    }
+    range = end + 1;
+    tabulate_to = strtod(range, &end);
+    if (end == range || *end || !(tabulate_from < tabulate_to)) {
+        return 1;
+    }
+    tabulate = 1;
+    return 0;
+}
+
+static double parse_value(const char *text, char **end) {
+    static const double powers[23] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const char *iter = text;
+    uint64_t mantissa = 0;
+    int digits = 0, exponent = 0, shift = 0;
+    char negative = 0, any = 0, exponent_negative = 0;
+    double value;
+    if (*iter == '-' || *iter == '+') {
+        negative = *iter++ == '-';
+    }
+    for (; *iter >= '0' && *iter <= '9'; ++iter, any = 1) {
+        if (mantissa || *iter != '0') {
+            mantissa = mantissa * 10 + (*iter - '0');
+            ++digits;
+        }
+        if (digits > 15) {
+            return strtod(text, end);
+        }
+    }
+    if (*iter == '.') {
+        for (++iter; *iter >= '0' && *iter <= '9'; ++iter, any = 1) {
+            if (mantissa || *iter != '0') {
+                mantissa = mantissa * 10 + (*iter - '0');
+                ++digits;
+            }
+            if (digits > 15) {
+                return strtod(text, end);
+            }
+            --shift;
+        }
+    }
+    if (any && (*iter == 'e' || *iter == 'E')) {
+        ++iter;
+        if (*iter == '-' || *iter == '+') {
+            exponent_negative = *iter++ == '-';
+        }
+        if (*iter < '0' || *iter > '9') {
+            return strtod(text, end);
+        }
+        for (; *iter >= '0' && *iter <= '9' && exponent < 1000; ++iter) {
+            exponent = exponent * 10 + (*iter - '0');
+        }
+    }
+    if (!any || (*iter && !isspace((unsigned char)*iter))) {
+        return strtod(text, end);
+    }
+    exponent = (exponent_negative ? -exponent : exponent) + shift;
+    if (exponent < -22 || exponent > 22) {
+        return strtod(text, end);
+    }
+    value = mantissa;
+    if (exponent < 0) {
+        value /= powers[-exponent];
+    } else {
+        value *= powers[exponent];
+    }
+    *end = (char *)iter;
+    return negative ? -value : value;
+}
+
+struct Power {
+    uint64_t significand;
+    int binary;
+    int decimal;
+};
+
+struct Fp {
+    uint64_t f;
+    int e;
+};
+
+/* 10^k ~ significand * 2^binary for k = -348, -340, ..., 340 */
+static const struct Power cached_powers[87] = {
+    { 0xfa8fd5a0081c0288ull, -1220, -348 },
+    { 0xbaaee17fa23ebf76ull, -1193, -340 },
+    { 0x8b16fb203055ac76ull, -1166, -332 },
+    { 0xcf42894a5dce35eaull, -1140, -324 },
+    { 0x9a6bb0aa55653b2dull, -1113, -316 },
+    { 0xe61acf033d1a45dfull, -1087, -308 },
+    { 0xab70fe17c79ac6caull, -1060, -300 },
+    { 0xff77b1fcbebcdc4full, -1034, -292 },
+    { 0xbe5691ef416bd60cull, -1007, -284 },
+    { 0x8dd01fad907ffc3cull, -980, -276 },
+    { 0xd3515c2831559a83ull, -954, -268 },
+    { 0x9d71ac8fada6c9b5ull, -927, -260 },
+    { 0xea9c227723ee8bcbull, -901, -252 },
+    { 0xaecc49914078536dull, -874, -244 },
+    { 0x823c12795db6ce57ull, -847, -236 },
+    { 0xc21094364dfb5637ull, -821, -228 },
+    { 0x9096ea6f3848984full, -794, -220 },
+    { 0xd77485cb25823ac7ull, -768, -212 },
+    { 0xa086cfcd97bf97f4ull, -741, -204 },
+    { 0xef340a98172aace5ull, -715, -196 },
+    { 0xb23867fb2a35b28eull, -688, -188 },
+    { 0x84c8d4dfd2c63f3bull, -661, -180 },
+    { 0xc5dd44271ad3cdbaull, -635, -172 },
+    { 0x936b9fcebb25c996ull, -608, -164 },
+    { 0xdbac6c247d62a584ull, -582, -156 },
+    { 0xa3ab66580d5fdaf6ull, -555, -148 },
+    { 0xf3e2f893dec3f126ull, -529, -140 },
+    { 0xb5b5ada8aaff80b8ull, -502, -132 },
+    { 0x87625f056c7c4a8bull, -475, -124 },
+    { 0xc9bcff6034c13053ull, -449, -116 },
+    { 0x964e858c91ba2655ull, -422, -108 },
+    { 0xdff9772470297ebdull, -396, -100 },
+    { 0xa6dfbd9fb8e5b88full, -369, -92 },
+    { 0xf8a95fcf88747d94ull, -343, -84 },
+    { 0xb94470938fa89bcfull, -316, -76 },
+    { 0x8a08f0f8bf0f156bull, -289, -68 },
+    { 0xcdb02555653131b6ull, -263, -60 },
+    { 0x993fe2c6d07b7facull, -236, -52 },
+    { 0xe45c10c42a2b3b06ull, -210, -44 },
+    { 0xaa242499697392d3ull, -183, -36 },
+    { 0xfd87b5f28300ca0eull, -157, -28 },
+    { 0xbce5086492111aebull, -130, -20 },
+    { 0x8cbccc096f5088ccull, -103, -12 },
+    { 0xd1b71758e219652cull, -77, -4 },
+    { 0x9c40000000000000ull, -50, 4 },
+    { 0xe8d4a51000000000ull, -24, 12 },
+    { 0xad78ebc5ac620000ull, 3, 20 },
+    { 0x813f3978f8940984ull, 30, 28 },
+    { 0xc097ce7bc90715b3ull, 56, 36 },
+    { 0x8f7e32ce7bea5c70ull, 83, 44 },
+    { 0xd5d238a4abe98068ull, 109, 52 },
+    { 0x9f4f2726179a2245ull, 136, 60 },
+    { 0xed63a231d4c4fb27ull, 162, 68 },
+    { 0xb0de65388cc8ada8ull, 189, 76 },
+    { 0x83c7088e1aab65dbull, 216, 84 },
+    { 0xc45d1df942711d9aull, 242, 92 },
+    { 0x924d692ca61be758ull, 269, 100 },
+    { 0xda01ee641a708deaull, 295, 108 },
+    { 0xa26da3999aef774aull, 322, 116 },
+    { 0xf209787bb47d6b85ull, 348, 124 },
+    { 0xb454e4a179dd1877ull, 375, 132 },
+    { 0x865b86925b9bc5c2ull, 402, 140 },
+    { 0xc83553c5c8965d3dull, 428, 148 },
+    { 0x952ab45cfa97a0b3ull, 455, 156 },
+    { 0xde469fbd99a05fe3ull, 481, 164 },
+    { 0xa59bc234db398c25ull, 508, 172 },
+    { 0xf6c69a72a3989f5cull, 534, 180 },
+    { 0xb7dcbf5354e9beceull, 561, 188 },
+    { 0x88fcf317f22241e2ull, 588, 196 },
+    { 0xcc20ce9bd35c78a5ull, 614, 204 },
+    { 0x98165af37b2153dfull, 641, 212 },
+    { 0xe2a0b5dc971f303aull, 667, 220 },
+    { 0xa8d9d1535ce3b396ull, 694, 228 },
+    { 0xfb9b7cd9a4a7443cull, 720, 236 },
+    { 0xbb764c4ca7a44410ull, 747, 244 },
+    { 0x8bab8eefb6409c1aull, 774, 252 },
+    { 0xd01fef10a657842cull, 800, 260 },
+    { 0x9b10a4e5e9913129ull, 827, 268 },
+    { 0xe7109bfba19c0c9dull, 853, 276 },
+    { 0xac2820d9623bf429ull, 880, 284 },
+    { 0x80444b5e7aa7cf85ull, 907, 292 },
+    { 0xbf21e44003acdd2dull, 933, 300 },
+    { 0x8e679c2f5e44ff8full, 960, 308 },
+    { 0xd433179d9c8cb841ull, 986, 316 },
+    { 0x9e19db92b4e31ba9ull, 1013, 324 },
+    { 0xeb96bf6ebadf77d9ull, 1039, 332 },
+    { 0xaf87023b9bf0ee6bull, 1066, 340 },
+};
+
+static struct Fp fp_multiply(struct Fp a, struct Fp b) {
+    unsigned __int128 p = (unsigned __int128)a.f * b.f;
+    struct Fp r = { (uint64_t)(p >> 64) + ((uint64_t)(p >> 63) & 1),
+                    a.e + b.e + 64 };
+    return r;
+}
+
+static struct Fp fp_normalize(uint64_t f, int e) {
+    int shift = __builtin_clzll(f);
+    struct Fp r = { f << shift, e - shift };
+    return r;
+}
+
+/*
+ * Moves the last digit towards the value while the result stays inside the
+ * unsafe interval, and reports whether it is provably the closest shortest.
+ */
+static char round_weed(char *digits, int length, uint64_t distance,
+                       uint64_t unsafe, uint64_t rest, uint64_t ten_kappa,
+                       uint64_t unit) {
+    uint64_t small = distance - unit, big = distance + unit;
+    while (rest < small && unsafe - rest >= ten_kappa &&
+           (rest + ten_kappa < small ||
+            small - rest >= rest + ten_kappa - small)) {
+        --digits[length - 1];
+        rest += ten_kappa;
+    }
+    if (rest < big && unsafe - rest >= ten_kappa &&
+        (rest + ten_kappa < big || big - rest > rest + ten_kappa - big)) {
+        return 0;
+    }
+    return 2 * unit <= rest && rest <= unsafe - 4 * unit;
+}
+
+static char digit_gen(struct Fp low, struct Fp w, struct Fp high,
+                      char *digits, int *length, int *kappa) {
+    uint64_t unit = 1, unsafe = high.f - low.f + 2 * unit;
+    uint64_t too_high = high.f + unit, one = 1ull << -w.e, rest;
+    uint64_t fractionals = too_high & (one - 1);
+    uint32_t integrals = too_high >> -w.e, divisor = 1;
+    *kappa = 1;
+    *length = 0;
+    for (; integrals / divisor >= 10; divisor *= 10, ++*kappa);
+    while (*kappa > 0) {
+        digits[(*length)++] = '0' + integrals / divisor;
+        integrals %= divisor;
+        --*kappa;
+        rest = ((uint64_t)integrals << -w.e) + fractionals;
+        if (rest < unsafe) {
+            return round_weed(digits, *length, too_high - w.f, unsafe, rest,
+                              (uint64_t)divisor << -w.e, unit);
+        }
+        divisor /= 10;
+    }
+    for (;;) {
+        fractionals *= 10;
+        unit *= 10;
+        unsafe *= 10;
+        digits[(*length)++] = '0' + (fractionals >> -w.e);
+        fractionals &= one - 1;
+        --*kappa;
+        if (fractionals < unsafe) {
+            return round_weed(digits, *length, (too_high - w.f) * unit,
+                              unsafe, fractionals, one, unit);
+        }
+    }
+}
+
+/* Grisu3: shortest digits of a finite positive value, or 0 when unsure */
+static char grisu(double value, char *digits, int *length, int *exponent) {
+    const struct Power *power;
+    struct Fp w, low, high;
+    uint64_t bits, f;
+    int e, k, kappa;
+    memcpy(&bits, &value, sizeof(bits));
+    f = bits & ((1ull << 52) - 1);
+    e = bits >> 52 & 0x7ff;
+    if (e) {
+        f |= 1ull << 52;
+        e -= 1075;
+    } else {
+        e = -1074;
+    }
+    w = fp_normalize(f, e);
+    high = fp_normalize((f << 1) + 1, e - 1);
+    if (f == 1ull << 52 && e > -1074) {
+        low.f = (f << 2) - 1;
+        low.e = e - 2;
+    } else {
+        low.f = (f << 1) - 1;
+        low.e = e - 1;
+    }
+    low.f <<= low.e - high.e;
+    low.e = high.e;
+    k = ceil((-60 - (w.e + 64) + 63) * 0.30102999566398114);
+    power = cached_powers + (348 + k - 1) / 8 + 1;
+    w = fp_multiply(w, (struct Fp){ power->significand, power->binary });
+    low = fp_multiply(low, (struct Fp){ power->significand, power->binary });
+    high = fp_multiply(high, (struct Fp){ power->significand, power->binary });
+    if (!digit_gen(low, w, high, digits, length, &kappa)) {
+        return 0;
+    }
+    *exponent = kappa - power->decimal;
+    return 1;
+}
+
+/* Shortest %e rendering that reads back as the same value */
+static void shortest_printf(double value, char *digits, int *length,
+                            int *exponent) {
+    char text[32];
+    int n;
+    for (int precision = 0; precision < 17; ++precision) {
+        snprintf(text, sizeof(text), "%.*e", precision, value);
+        if (strtod(text, NULL) == value || precision == 16) {
+            n = 0;
+            for (char *c = text; *c != 'e'; ++c) {
+                if (*c != '.') {
+                    digits[n++] = *c;
+                }
+            }
+            for (; n > 1 && digits[n - 1] == '0'; --n);
+            *length = n;
+            *exponent = atoi(strchr(text, 'e') + 1) - n + 1;
+            return;
+        }
+    }
+}
+
+/*
+ * Writes the shortest decimal that reads back as value, laid out like
+ * %.17g: positional for decimal exponents in [-4, 17), scientific otherwise.
+ */
+static char *format_value(char *iter, double value) {
+    char digits[24];
+    int length, exponent, point;
+    if (signbit(value)) {
+        *iter++ = '-';
+        value = -value;
+    }
+    if (value != value || value == INFINITY || !value) {
+        strcpy(iter, value != value ? "nan" : value ? "inf" : "0");
+        return iter + strlen(iter);
+    }
+    if (!grisu(value, digits, &length, &exponent)) {
+        shortest_printf(value, digits, &length, &exponent);
+    }
+    for (; length > 1 && digits[length - 1] == '0'; --length, ++exponent);
+    point = length + exponent - 1;
+    if (point < -4 || point >= 17) {
+        *iter++ = digits[0];
+        if (length > 1) {
+            *iter++ = '.';
+            memcpy(iter, digits + 1, length - 1);
+            iter += length - 1;
+        }
+        return iter + sprintf(iter, "e%c%02d", point < 0 ? '-' : '+',
+                              point < 0 ? -point : point);
+    }
+    if (point < 0) {
+        memcpy(iter, "0.0000", 1 - point);
+        iter += 1 - point;
+        memcpy(iter, digits, length);
+        return iter + length;
+    }
+    if (length <= point + 1) {
+        memcpy(iter, digits, length);
+        memset(iter + length, '0', point + 1 - length);
+        return iter + point + 1;
+    }
+    memcpy(iter, digits, point + 1);
+    iter[point + 1] = '.';
+    memcpy(iter + point + 2, digits + point + 1, length - point - 1);
+    return iter + length + 1;
+}
+
+static void print_value(double value, char last) {
+    char text[32];
+    char *end = format_value(text, value);
+    *end++ = last ? '\n' : ' ';
+    fwrite(text, 1, end - text, stdout);
+}
+
+static int evaluate_stream(void) {
+    static char in_buf[IO_SIZE + 1];
+    static char out_buf[IO_SIZE];
+    double xs[VALUES], ys[VALUES];
+    size_t filled = 0, count = 0, got;
+    char *iter, *end, *out_iter = out_buf;
+    char eof = 0;
+    int ret;
+    while (!eof || filled) {
+        if (!eof) {
+            got = fread(in_buf + filled, 1, IO_SIZE - filled, stdin);
+            filled += got;
+            eof = !got;
+        }
+        in_buf[filled] = 0;
+        iter = in_buf;
+        for (;;) {
+            for (; isspace((unsigned char)*iter); ++iter);
+            if (!*iter) {
+                break;
+            }
+            end = iter;
+            for (; *end && !isspace((unsigned char)*end); ++end);
+            if (!*end && !eof) {
+                break;
+            }
+            xs[count] = parse_value(iter, &end);
+            if (end == iter) {
+                fprintf(stderr, "Invalid input\n");
+                return 1;
+            }
+            iter = end;
+            if (++count == VALUES) {
+                ret = core_evaluate_batch(xs, ys, count);
+                if (ret) {
+                    fprintf(stderr, "Evaluation error %d\n", ret);
+                    return 1;
+                }
+                for (size_t i = 0; i < count; ++i) {
+                    if (out_iter - out_buf > IO_SIZE - 32) {
+                        fwrite(out_buf, 1, out_iter - out_buf, stdout);
+                        out_iter = out_buf;
+                    }
+                    out_iter = format_value(out_iter, ys[i]);
+                    *out_iter++ = '\n';
+                }
+                count = 0;
+            }
+        }
+        filled = in_buf + filled - iter;
+        memmove(in_buf, iter, filled);
+        if (eof) {
+            break;
+        }
+    }
+    ret = core_evaluate_batch(xs, ys, count);
+    if (ret) {
+        fprintf(stderr, "Evaluation error %d\n", ret);
+        return 1;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (out_iter - out_buf > IO_SIZE - 32) {
+            fwrite(out_buf, 1, out_iter - out_buf, stdout);
+            out_iter = out_buf;
+        }
+        out_iter = format_value(out_iter, ys[i]);
+        *out_iter++ = '\n';
+    }
+    fwrite(out_buf, 1, out_iter - out_buf, stdout);
+    return 0;
+}
+
+static int integrate(int argc, char **argv) {
+    double from, to, res, err;
+    unsigned long chunk = 1000000;
+    int ret;
+    if (argc < 2) {
+        fprintf(stderr, "integrate needs FROM and TO\n");
+        return 1;
+    }
+    from = atof(argv[0]);
+    to = atof(argv[1]);
+    if (argc > 2) {
+        chunk = strtoul(argv[2], NULL, 10);
+    }
+    if (default_context.rule == RULE_ADAPTIVE) {
+        ret = core_integrate_adaptive(from, to,
+                                      default_context.abs_tol,
+                                      default_context.rel_tol,
+                                      argc > 2 && chunk ? chunk :
+                                      default_context.limit,
+                                      &res, &err);
+        if (!ret) {
+            print_value(res, 0);
+            printf("%.3g\n", err);
+        }
+    } else {
+        ret = core_integrate(from, to, chunk, &res);
+        if (!ret) {
+            print_value(res, 1);
+        }
+    }
+    if (ret) {
+        fprintf(stderr, "Integration error %d\n", ret);
+        return 1;
+    }
+    return 0;
+}
+
+static int plot_data(int argc, char **argv) {
+    double xs[VALUES], ys[VALUES];
+    double from, to, step;
+    unsigned long n, len;
+    int ret;
+    if (argc < 3) {
+        fprintf(stderr, "plot needs FROM, TO and N\n");
+        return 1;
+    }
+    from = atof(argv[0]);
+    to = atof(argv[1]);
+    n = strtoul(argv[2], NULL, 10);
+    step = n > 1 ? (to - from) / (n - 1) : 0;
+    for (unsigned long i = 0; i < n; i += len) {
+        len = n - i < VALUES ? n - i : VALUES;
+        for (unsigned long j = 0; j < len; ++j) {
+            xs[j] = i + j == n - 1 && n > 1 ? to : from + (i + j) * step;
+        }
+        ret = core_evaluate_batch(xs, ys, len);
+        if (ret) {
+            fprintf(stderr, "Evaluation error %d\n", ret);
+            return 1;
+        }
+        for (unsigned long j = 0; j < len; ++j) {
+            print_value(xs[j], 0);
+            print_value(ys[j], 1);
+        }
+    }
+    return 0;
+}
+
+static int derive(int argc, char **argv) {
+    struct Dual y;
+    double from, to, step, x;
+    unsigned long n;
+    int ret;
+    if (argc < 3) {
+        fprintf(stderr, "derive needs FROM, TO and N\n");
+        return 1;
+    }
+    from = atof(argv[0]);
+    to = atof(argv[1]);
+    n = strtoul(argv[2], NULL, 10);
+    step = n > 1 ? (to - from) / (n - 1) : 0;
+    for (unsigned long i = 0; i < n; ++i) {
+        x = i == n - 1 && n > 1 ? to : from + i * step;
+        ret = core_derivative(x, &y);
+        if (ret) {
+            fprintf(stderr, "Evaluation error %d\n", ret);
+            return 1;
+        }
+        print_value(x, 0);
+        print_value(y.value, 0);
+        print_value(y.first, 0);
+        print_value(y.second, 1);
+    }
+    return 0;
+}
+
+static int find(int argc, char **argv, char extrema) {
+    struct Extremum *points = NULL;
+    double *roots = NULL;
+    double from, to;
+    unsigned long scan = SOLVE_SCAN, evaluations, enclosures;
+    size_t count;
+    int ret;
+    if (argc < 2) {
+        fprintf(stderr, "%s needs FROM and TO\n",
+                extrema ? "extrema" : "roots");
+        return 1;
+    }
+    from = atof(argv[0]);
+    to = atof(argv[1]);
+    if (argc > 2) {
+        scan = strtoul(argv[2], NULL, 10);
+    }
+    if (extrema) {
+        points = malloc(scan * sizeof(struct Extremum));
+        ret = !points || solve_extrema(&default_context, from, to, scan,
+                                       points, scan, &count, &evaluations,
+                                       &enclosures);
+    } else {
+        roots = malloc(scan * sizeof(double));
+        ret = !roots || solve_roots(&default_context, from, to, scan,
+                                    roots, scan, &count, &evaluations,
+                                    &enclosures);
+    }
+    if (ret) {
+        fprintf(stderr, "Search error\n");
+        free(points);
+        free(roots);
+        return 1;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (extrema) {
+            print_value(points[i].x, 0);
+            print_value(points[i].y, 0);
+            printf("%s\n", points[i].maximum ? "max" : "min");
+        } else {
+            print_value(roots[i], 1);
+        }
+    }
+    fprintf(stderr, "%zu found, %lu evaluations, %lu enclosures\n",
+            count, evaluations, enclosures);
+    free(points);
+    free(roots);
+    return 0;
+}
+
+static int bound(int argc, char **argv) {
+    struct Bounds y;
+    int ret;
+    if (argc < 2) {
+        fprintf(stderr, "bound needs FROM and TO\n");
+        return 1;
+    }
+    ret = core_bound(atof(argv[0]), atof(argv[1]), &y);
+    if (ret) {
+        fprintf(stderr, "Bound error %d\n", ret);
+        return 1;
+    }
+    print_value(y.lo, 0);
+    print_value(y.hi, 1);
+    return 0;
+}
+
+static void swap_doubles(double *values, size_t n) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    uint64_t bits;
+    for (size_t i = 0; i < n; ++i) {
+        memcpy(&bits, values + i, 8);
+        bits = __builtin_bswap64(bits);
+        memcpy(values + i, &bits, 8);
+    }
+#else
+    (void)values;
+    (void)n;
+#endif
+}
+
+static int map_files(int argc, char **argv) {
+    struct stat info;
+    double *in = MAP_FAILED, *out = MAP_FAILED;
+    size_t n;
+    int fin = -1, fout = -1;
+    int ret = 1;
+    if (argc < 2) {
+        fprintf(stderr, "map needs INPUT and OUTPUT\n");
+        return 1;
+    }
+    fin = open(argv[0], O_RDONLY);
+    if (fin < 0 || fstat(fin, &info) || info.st_size % sizeof(double)) {
+        fprintf(stderr, "Invalid input file %s\n", argv[0]);
+        goto cleanup;
+    }
+    n = info.st_size / sizeof(double);
+    fout = open(argv[1], O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fout < 0 || ftruncate(fout, info.st_size)) {
+        fprintf(stderr, "Cannot create %s\n", argv[1]);
+        goto cleanup;
+    }
+    if (!n) {
+        ret = 0;
+        goto cleanup;
+    }
+    in = mmap(NULL, info.st_size,
+              PROT_READ | PROT_WRITE, MAP_PRIVATE, fin, 0);
+    out = mmap(NULL, info.st_size,
+               PROT_READ | PROT_WRITE, MAP_SHARED, fout, 0);
+    if (in == MAP_FAILED || out == MAP_FAILED) {
+        fprintf(stderr, "Cannot map files\n");
+        goto cleanup;
+    }
+    madvise(in, info.st_size, MADV_SEQUENTIAL);
+    madvise(out, info.st_size, MADV_SEQUENTIAL);
+    swap_doubles(in, n);
+    ret = core_evaluate_parallel(in, out, n);
+    if (ret) {
+        fprintf(stderr, "Evaluation error %d\n", ret);
+        ret = 1;
+        goto cleanup;
+    }
+    swap_doubles(out, n);
+cleanup:
+    if (in != MAP_FAILED) {
+        munmap(in, info.st_size);
+    }
+    if (out != MAP_FAILED) {
+        munmap(out, info.st_size);
+    }
+    if (fin >= 0) {
+        close(fin);
+    }
+    if (fout >= 0) {
+        close(fout);
+    }
+    return ret;
+}
+
+int cli_run(const char *path, int argc, char **argv) {
+    static char out_buf[IO_SIZE];
+    const char *command = argv[0];
+    char *text = NULL;
+    int ret;
+    ++argv;
+    --argc;
+    if (path) {
+        text = read_file(path);
+        if (!text) {
+            fprintf(stderr, "Cannot read %s\n", path);
+            return 1;
+        }
+    } else if (argc) {
+        text = strdup(argv[0]);
+        ++argv;
+        --argc;
+    } else {
+        fprintf(stderr, "No expression\n");
+        return 1;
+    }
+    ret = cli_parse(text, expression);
+    free(text);
+    if (ret) {
+        fprintf(stderr, "Invalid expression\n");
+        return 1;
+    }
+    ret = core_compile();
+    if (ret) {
+        fprintf(stderr, "Invalid program %d\n", ret);
+        return 1;
+    }
+    if (tabulate) {
+        ret = core_tabulate(tabulate_from, tabulate_to);
+        if (ret) {
+            fprintf(stderr, "Cannot tabulate %d\n", ret);
+            return 1;
+        }
+        fprintf(stderr, "Chebyshev degree %d error %.3g\n",
+                default_context.chebyshev.degree,
+                default_context.chebyshev.error);
+    }
+    setvbuf(stdout, out_buf, _IOFBF, IO_SIZE);
+    if (!strcmp(command, "eval")) {
+        ret = evaluate_stream();
+    } else if (!strcmp(command, "integrate")) {
+        ret = integrate(argc, argv);
+    } else if (!strcmp(command, "plot")) {
+        ret = plot_data(argc, argv);
+    } else if (!strcmp(command, "derive")) {
+        ret = derive(argc, argv);
+    } else if (!strcmp(command, "roots")) {
+        ret = find(argc, argv, 0);
+    } else if (!strcmp(command, "extrema")) {
+        ret = find(argc, argv, 1);
+    } else if (!strcmp(command, "bound")) {
+        ret = bound(argc, argv);
+    } else if (!strcmp(command, "map")) {
+        ret = map_files(argc, argv);
+    } else {
+        fprintf(stderr, "Unknown command %s\n", command);
+        ret = 1;
+    }
+    fflush(stdout);
+    return ret;
+}
@@ -0,0 +1,13 @@
+#ifndef _CLI_H_
+#define _CLI_H_
+
+#include "../core/core.h"
+
+int cli_parse(const char *text, struct Symbol *expression);
+int cli_rule(const char *name);
+int cli_math(const char *name);
+int cli_precision(const char *name);
+int cli_tabulate(const char *range);
+int cli_run(const char *path, int argc, char **argv);
+
+#endif
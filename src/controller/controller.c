@@ -4,6 +4,9 @@
 #include <ncurses.h>
 #include "controller.h"
 #include "../core/core.h"
+#include "../stats/stats.h"
+#include "../solve/solve.h"
+#include "../precision/precision.h"
 
 #define SELECTION 0
 #define ENTRY_TYPE 1
@@ -18,11 +21,27 @@
 #define INTEGRATE_ENTRY 10
 #define PLOT 11
 #define PLOT_ENTRY 12
+#define OVERSAMPLE 8
+#define TILE 32
+#define TILES 256
+#define ZOOM 40
 
-static char page, selection[8], level, mode;
+struct Tile {
+    double lows[TILE];
+    double highs[TILE];
+    struct Bounds bounds[TILE];
+    unsigned long stamp;
+    long index;
+    int zoom;
+    char used;
+};
+
+static char page, selection[8], level, mode, derive, search;
 static const char *template = "+0.000000E+00";
 static char buf[14];
 static double x, start, end, chunk;
+static struct Tile tiles[TILES];
+static unsigned long tile_clock;
 
 static void render_selection(void) {
     for (int i = 0; i < 10; ++i) {
@@ -51,6 +70,14 @@ static void render_selection(void) {
             break;
         }
     }
+    const struct Program *program = &default_context.program;
+    if (program->status) {
+        mvprintw(0, 20, "%-35s", "Program invalid");
+    } else {
+        mvprintw(0, 20,
+                 "Ops %3u Removed %+4d Shared %3d",
+                 program->length, program->removed, program->shared);
+    }
     move(selection[0], 16);
 }
 
@@ -111,32 +138,39 @@ static void remove_entry_binary(void) {
 }
 
 static void render_perform(void) {
-    static const char *names[3] = {
+    static const char *names[8] = {
         "Evaluate",
+        "Derive",
         "Integrate",
-        "Plot"
+        "Plot",
+        "Roots",
+        "Extrema",
+        "Tabulate",
+        "Stats"
     };
-    for (int i = 0; i < 3; ++i) {
+    for (int i = 0; i < 8; ++i) {
         mvprintw(11 + i, 0, "%s", names[i]);
     }
     move(11 + selection[level], 0);
 }
 
 static void remove_perform(void) {
-    for (int i = 0; i < 3; ++i) {
+    for (int i = 0; i < 8; ++i) {
         mvprintw(11 + i, 0, "%9s", " ");
     }
 }
 
 static void render_evaluate(void) {
     mvprintw(11, 10, "%s %+.6E", "X", x);
-    mvprintw(12, 10, "Evaluate");
+    mvprintw(12, 10, "%-5s %-13s", "Prec",
+             precision_names[default_context.precision]);
+    mvprintw(13, 10, "%s", derive ? "Derive" : "Evaluate");
     move(11, 10);
 }
 
 static void remove_evaluate(void) {
-    for (int i = 0; i < 2; ++i) {
-        mvprintw(11 + i, 10, "%15s", " ");
+    for (int i = 0; i < 3; ++i) {
+        mvprintw(11 + i, 10, "%19s", " ");
     }
 }
 
@@ -144,12 +178,15 @@ static void render_integrate(void) {
     mvprintw(11, 10, "%-5s %+.6E", "Start", start);
     mvprintw(12, 10, "%-5s %+.6E", "End", end);
     mvprintw(13, 10, "%-5s %+.6E", "Chunk", chunk);
-    mvprintw(14, 10, "Integrate");
+    mvprintw(14, 10, "%-5s %-13s", "Rule", rule_names[default_context.rule]);
+    mvprintw(15, 10, "%-5s %-13s", "Prec",
+             precision_names[default_context.precision]);
+    mvprintw(16, 10, "Integrate");
     move(11, 10);
 }
 
 static void remove_integrate(void) {
-    for (int i = 0; i < 4; ++i) {
+    for (int i = 0; i < 6; ++i) {
         mvprintw(11 + i, 10, "%19s", " ");
     }
 }
@@ -157,61 +194,242 @@ static void remove_integrate(void) {
 static void render_plot(void) {
     mvprintw(11, 10, "%-5s %+.6E", "Start", start);
     mvprintw(12, 10, "%-5s %+.6E", "End", end);
-    mvprintw(13, 10, "Plot");
+    mvprintw(13, 10, "%-5s %-13s", "Prec",
+             precision_names[default_context.precision]);
+    mvprintw(14, 10, "%s", search == 3 ? "Fit" : search ? "Find" : "Plot");
     move(11, 10);
 }
 
 static void remove_plot(void) {
-    for (int i = 0; i < 3; ++i) {
+    for (int i = 0; i < 4; ++i) {
         mvprintw(11 + i, 10, "%19s", " ");
     }
 }
 
 
+static struct Tile *find_tile(int zoom, long index) {
+    struct Tile *oldest = tiles;
+    for (int i = 0; i < TILES; ++i) {
+        if (tiles[i].used && tiles[i].zoom == zoom && tiles[i].index == index) {
+            tiles[i].stamp = ++tile_clock;
+            return tiles + i;
+        }
+        if (!tiles[i].used || tiles[i].stamp < oldest->stamp) {
+            oldest = tiles + i;
+        }
+    }
+    oldest->used = 0;
+    return oldest;
+}
+
+static int fill_tiles(struct Tile **missing, int count, double base) {
+    unsigned long n = (unsigned long)count * TILE * OVERSAMPLE;
+    double *xs = malloc(n * sizeof(double));
+    double *ys = malloc(n * sizeof(double));
+    double *x = xs, *y = ys;
+    double width;
+    int ret = 1;
+    if (!xs || !ys) {
+        goto cleanup;
+    }
+    for (int t = 0; t < count; ++t) {
+        width = ldexp(base, missing[t]->zoom);
+        for (long c = 0; c < TILE; ++c) {
+            for (int j = 0; j < OVERSAMPLE; ++j) {
+                *(x++) = start + ((missing[t]->index * TILE + c) +
+                                  (j + 0.5) / OVERSAMPLE) * width;
+            }
+        }
+    }
+    if (core_evaluate_batch(xs, ys, n)) {
+        goto cleanup;
+    }
+    for (int t = 0; t < count; ++t) {
+        width = ldexp(base, missing[t]->zoom);
+        for (long c = 0; c < TILE; ++c) {
+            if (core_bound(start + (missing[t]->index * TILE + c) * width,
+                           start + (missing[t]->index * TILE + c + 1) * width,
+                           missing[t]->bounds + c)) {
+                missing[t]->bounds[c].lo = NAN;
+                missing[t]->bounds[c].hi = NAN;
+            }
+        }
+        for (int c = 0; c < TILE; ++c) {
+            missing[t]->lows[c] = INFINITY;
+            missing[t]->highs[c] = -INFINITY;
+            for (int j = 0; j < OVERSAMPLE; ++j, ++y) {
+                if (isfinite(*y)) {
+                    missing[t]->lows[c] = fmin(missing[t]->lows[c], *y);
+                    missing[t]->highs[c] = fmax(missing[t]->highs[c], *y);
+                }
+            }
+        }
+    }
+    ret = 0;
+cleanup:
+    free(xs);
+    free(ys);
+    return ret;
+}
+
+static int draw_plot(int zoom, long left, double base) {
+    struct Tile *missing[TILES];
+    struct Tile *tile;
+    struct Bounds bounds;
+    int width = COLS, height = LINES - 1;
+    long first = left >= 0 ? left / TILE : -((TILE - 1 - left) / TILE);
+    long last = (left + width - 1) >= 0 ? (left + width - 1) / TILE :
+                -((TILE - left - width) / TILE);
+    double min = INFINITY, max = -INFINITY, range, low, high;
+    int count = 0, top, bottom;
+    if (width < 1 || height < 2 || last - first + 1 > TILES) {
+        return 0;
+    }
+    for (long t = first; t <= last; ++t) {
+        tile = find_tile(zoom, t);
+        if (!tile->used) {
+            tile->zoom = zoom;
+            tile->index = t;
+            tile->stamp = ++tile_clock;
+            tile->used = 1;
+            missing[count++] = tile;
+        }
+    }
+    if (count && fill_tiles(missing, count, base)) {
+        for (int t = 0; t < count; ++t) {
+            missing[t]->used = 0;
+        }
+        return 1;
+    }
+    for (long c = left; c < left + width; ++c) {
+        tile = find_tile(zoom, c >= 0 ? c / TILE : -((TILE - 1 - c) / TILE));
+        bounds = tile->bounds[c - tile->index * TILE];
+        if (isfinite(bounds.lo) && isfinite(bounds.hi)) {
+            min = fmin(min, bounds.lo);
+            max = fmax(max, bounds.hi);
+        } else {
+            min = fmin(min, tile->lows[c - tile->index * TILE]);
+            max = fmax(max, tile->highs[c - tile->index * TILE]);
+        }
+    }
+    clear();
+    range = max - min;
+    for (long c = left; c < left + width && min <= max; ++c) {
+        tile = find_tile(zoom, c >= 0 ? c / TILE : -((TILE - 1 - c) / TILE));
+        low = tile->lows[c - tile->index * TILE];
+        high = tile->highs[c - tile->index * TILE];
+        if (low > high) {
+            continue;
+        }
+        top = range ? height - (high - min) / range * (height - 1) :
+                      1 + height / 2;
+        bottom = range ? height - (low - min) / range * (height - 1) :
+                         1 + height / 2;
+        for (int row = top; row <= bottom; ++row) {
+            mvaddch(row, c - left, '*');
+        }
+    }
+    mvprintw(0, 0, "X %+.6E %+.6E Y %+.6E %+.6E",
+             start + left * ldexp(base, zoom),
+             start + (left + width) * ldexp(base, zoom),
+             min <= max ? min : NAN, min <= max ? max : NAN);
+    return 0;
+}
+
 static void plot(void) {
+    double base = (end - start) / COLS, fit;
+    long left = 0, center;
+    int zoom = 0, in;
     if (start >= end) {
         mvprintw(10, 0, "Error");
         getch();
         mvprintw(10, 0, "%5s", " ");
         return;
     }
-    double vals[40];
-    double step = (end - start) / 40;
-    double cur = start;
-    double *val_iter = vals;
-    char set = 0;
-    double min, max;
-    for (int i = 0; i < 40; ++i, ++val_iter, cur += step) {
-        if (core_evaluate(cur, val_iter)) {
+    memset(tiles, 0, sizeof(tiles));
+    for (;;) {
+        STATS_TIMER(begin);
+        if (draw_plot(zoom, left, base)) {
             mvprintw(10, 0, "Error");
             getch();
-            mvprintw(10, 0, "%5s", " ");
-            return;
+            break;
         }
-        if (!isnan(*val_iter)) {
-            if (!set) {
-                set = 1;
-                min = *val_iter;
-                max = *val_iter;
-            } else {
-                if (*val_iter < min) {
-                    min = *val_iter;
-                }
-                if (*val_iter > max) {
-                    max = *val_iter;
-                }
+        STATS_ELAPSED(plot_seconds, plots, begin);
+        in = getch();
+        center = left + COLS / 2;
+        if (in == KEY_LEFT || in == 'A' || in == 'a') {
+            left -= COLS / 4 > 0 ? COLS / 4 : 1;
+        } else if (in == KEY_RIGHT || in == 'D' || in == 'd') {
+            left += COLS / 4 > 0 ? COLS / 4 : 1;
+        } else if ((in == '+' || in == '=' || in == KEY_UP ||
+                    in == 'W' || in == 'w') && zoom > -ZOOM) {
+            --zoom;
+            left = 2 * center - COLS / 2;
+        } else if ((in == '-' || in == '_' || in == KEY_DOWN ||
+                    in == 'S' || in == 's') && zoom < ZOOM) {
+            ++zoom;
+            left = (center >= 0 ? center / 2 : -((1 - center) / 2)) -
+                   COLS / 2;
+        } else if (in == KEY_RESIZE) {
+            fit = (end - start) / COLS;
+            if (!zoom && fit != base) {
+                left = lround(left * base / fit);
+                base = fit;
+                memset(tiles, 0, sizeof(tiles));
             }
+        } else {
+            break;
         }
     }
-    if (!set) {
+    clear();
+    render_selection();
+    render_perform();
+    render_plot();
+}
+
+static void fit(void) {
+    const struct Chebyshev *chebyshev = &default_context.chebyshev;
+    if (core_tabulate(start, end)) {
+        mvprintw(10, 0, "Result: %13s", "Error");
+    } else {
+        mvprintw(10, 0, "Degree %d Error %.1E", chebyshev->degree,
+                 chebyshev->error);
+    }
+    getch();
+    mvprintw(10, 0, "%30s", " ");
+    move(13, 10);
+}
+
+static void show_found(void) {
+    struct Extremum extrema[64];
+    double roots[64];
+    unsigned long evaluations, enclosures;
+    size_t count;
+    int ret, row = 1;
+    if (search == 2) {
+        ret = solve_extrema(&default_context, start, end, SOLVE_SCAN,
+                            extrema, 64, &count, &evaluations,
+                            &enclosures);
+    } else {
+        ret = solve_roots(&default_context, start, end, SOLVE_SCAN,
+                          roots, 64, &count, &evaluations, &enclosures);
+    }
+    if (ret) {
+        mvprintw(10, 0, "Error");
+        getch();
+        mvprintw(10, 0, "%5s", " ");
         return;
     }
     clear();
-    double range = max - min;
-    val_iter = vals;
-    for (int i = 0; i < 40; ++i, ++val_iter) {
-        if (!isnan(*val_iter)) {
-            mvaddch(19 - (*val_iter - min) / range * 19, i, '*');
+    mvprintw(0, 0, "%zu %s, %lu evaluations, %lu enclosures", count,
+             search == 2 ? "extrema" : "roots", evaluations, enclosures);
+    for (size_t i = 0; i < count && i < 64 && row < LINES - 1; ++i, ++row) {
+        if (search == 2) {
+            mvprintw(row, 0, "%s X %+.15E Y %+.15E",
+                     extrema[i].maximum ? "Max" : "Min",
+                     extrema[i].x, extrema[i].y);
+        } else {
+            mvprintw(row, 0, "X %+.15E", roots[i]);
         }
     }
     getch();
@@ -221,6 +439,53 @@ static void plot(void) {
     render_plot();
 }
 
+static void render_stats(void) {
+    const struct Memo *memo = &default_context.memo;
+    int row = 1;
+    clear();
+    if (!STATS_ENABLED) {
+        mvprintw(0, 0, "Statistics not compiled in (make STATS=1)");
+        mvprintw(2, 0, "Cache %llu hits %llu misses %llu evictions",
+                 memo->hits, memo->misses, memo->evictions);
+        mvprintw(4, 0, "R to reset, any other key to return");
+        return;
+    }
+    mvprintw(0, 0, "%-8s %14s %16s %9s", "Op", "Count", "Cycles", "Cyc/op");
+    for (int i = 0; i < STATS_OPS; ++i) {
+        if (!stats.counts[i]) {
+            continue;
+        }
+        mvprintw(row++, 0, "%-8s %14llu %16llu %9.1f",
+                 stats_name(i), stats.counts[i], stats.cycles[i],
+                 (double)stats.cycles[i] / stats.counts[i]);
+    }
+    mvprintw(++row, 0, "Evaluations %llu NaN %llu Inf %llu",
+             stats.evaluations, stats.nans, stats.infs);
+    mvprintw(++row, 0, "Integrate %llu calls %.6f s",
+             stats.integrations, stats.integrate_seconds);
+    mvprintw(++row, 0, "Plot %llu calls %.6f s",
+             stats.plots, stats.plot_seconds);
+    mvprintw(++row, 0, "Cache %llu hits %llu misses %llu evictions",
+             memo->hits, memo->misses, memo->evictions);
+    mvprintw(row + 2, 0, "R to reset, any other key to return");
+}
+
+static void show_stats(void) {
+    int in;
+    for (;;) {
+        render_stats();
+        in = getch();
+        if (in != 'R' && in != 'r') {
+            break;
+        }
+        stats_reset();
+        memo_reset(&default_context.memo);
+    }
+    clear();
+    render_selection();
+    render_perform();
+}
+
 void controller_initialize(void) {
     initscr();
     keypad(stdscr, TRUE);
@@ -233,6 +498,7 @@ void controller_initialize(void) {
     start = 0;
     end = 0;
     chunk = 0;
+    core_compile();
     render_selection();
 }
 
@@ -242,7 +508,8 @@ void controller_finalize(void) {
 
 int controller_handle(void) {
     int in = getch();
-    double res;
+    struct Dual dual;
+    double res, err;
     int ret;
     switch (in) {
     case 'Q':
@@ -364,11 +631,11 @@ int controller_handle(void) {
             move(11 + selection[level], 7);
             break;
         case PERFORM:
-            selection[level] = (((selection[level] - 1) % 3) + 3) % 3;
+            selection[level] = (((selection[level] - 1) % 8) + 8) % 8;
             move(11 + selection[level], 0);
             break;
         case EVALUATE:
-            selection[level] = (((selection[level] - 1) % 2) + 2) % 2;
+            selection[level] = (((selection[level] - 1) % 3) + 3) % 3;
             move(11 + selection[level], 10);
             break;
         case EVALUATE_ENTRY:
@@ -417,7 +684,7 @@ int controller_handle(void) {
             move(11, 12 + selection[level]);
             break;
         case INTEGRATE:
-            selection[level] = (((selection[level] - 1) % 4) + 4) % 4;
+            selection[level] = (((selection[level] - 1) % 6) + 6) % 6;
             move(11 + selection[level], 10);
             break;
         case INTEGRATE_ENTRY:
@@ -467,7 +734,7 @@ int controller_handle(void) {
             move(11 + selection[level - 1], 16 + selection[level]);
             break;
         case PLOT:
-            selection[level] = (((selection[level] - 1) % 3) + 3) % 3;
+            selection[level] = (((selection[level] - 1) % 4) + 4) % 4;
             move(11 + selection[level], 10);
             break;
         }
@@ -548,11 +815,11 @@ int controller_handle(void) {
             move(11 + selection[level], 7);
             break;
         case PERFORM:
-            selection[level] = (selection[level] + 1) % 3;
+            selection[level] = (selection[level] + 1) % 8;
             move(11 + selection[level], 0);
             break;
         case EVALUATE:
-            selection[level] = (selection[level] + 1) % 2;
+            selection[level] = (selection[level] + 1) % 3;
             move(11 + selection[level], 10);
             break;
         case EVALUATE_ENTRY:
@@ -607,7 +874,7 @@ int controller_handle(void) {
             move(11, 12 + selection[level]);
             break;
         case INTEGRATE:
-            selection[level] = (selection[level] + 1) % 4;
+            selection[level] = (selection[level] + 1) % 6;
             move(11 + selection[level], 10);
             break;
         case INTEGRATE_ENTRY:
@@ -663,7 +930,7 @@ int controller_handle(void) {
             move(11 + selection[level - 1], 16 + selection[level]);
             break;
         case PLOT:
-            selection[level] = (selection[level] + 1) % 3;
+            selection[level] = (selection[level] + 1) % 4;
             move(11 + selection[level], 10);
             break;
         }
@@ -686,6 +953,7 @@ int controller_handle(void) {
                 selection[level] = 0;
                 --level;
                 expression[page * 10 + selection[level]].type = NOP;
+                core_compile();
                 remove_entry_type();
                 render_selection();
                 break;
@@ -709,6 +977,7 @@ int controller_handle(void) {
                 selection[level] = 0;
                 --level;
                 expression[page * 10 + selection[level]].type = INPUT;
+                core_compile();
                 remove_entry_type();
                 render_selection();
                 break;
@@ -729,6 +998,7 @@ int controller_handle(void) {
                 memset(selection + 1, 0, 7);
                 expression[page * 10 + selection[level]].type = NUMBER;
                 expression[page * 10 + selection[level]].data.number = pi;
+                core_compile();
                 remove_entry_number();
                 remove_entry_type();
                 render_selection();
@@ -740,6 +1010,7 @@ int controller_handle(void) {
             level = 0;
             expression[page * 10 + selection[0]].type = NUMBER;
             expression[page * 10 + selection[0]].data.number = atof(buf);
+            core_compile();
             strcpy(buf, template);
             memset(selection + 1, 0, 7);
             mvprintw(11, 13, "%13s", " ");
@@ -752,6 +1023,7 @@ int controller_handle(void) {
             level = 0;
             expression[page * 10 + selection[0]].type = UNARY;
             expression[page * 10 + selection[0]].data.unary = selection[2];
+            core_compile();
             memset(selection + 1, 0, 7);
             remove_entry_unary();
             remove_entry_type();
@@ -762,6 +1034,7 @@ int controller_handle(void) {
             level = 0;
             expression[page * 10 + selection[0]].type = BINARY;
             expression[page * 10 + selection[0]].data.unary = selection[2];
+            core_compile();
             memset(selection + 1, 0, 7);
             remove_entry_binary();
             remove_entry_type();
@@ -770,20 +1043,29 @@ int controller_handle(void) {
         case PERFORM:
             switch (selection[level]) {
             case 0:
+            case 1:
                 mode = EVALUATE;
+                derive = selection[level];
                 ++level;
                 render_evaluate();
                 break;
-            case 1:
+            case 2:
                 mode = INTEGRATE;
                 ++level;
                 render_integrate();
                 break;
-            case 2:
+            case 3:
+            case 4:
+            case 5:
+            case 6:
                 mode = PLOT;
+                search = selection[level] - 3;
                 ++level;
                 render_plot();
                 break;
+            case 7:
+                show_stats();
+                break;
             }
             break;
         case EVALUATE:
@@ -795,14 +1077,28 @@ int controller_handle(void) {
                 move(11, 12);
                 break;
             case 1:
-                ret = core_evaluate(x, &res);
-                if (!ret) {
-                    mvprintw(10, 0, "Result: %+.6E", res);
+                default_context.precision = (default_context.precision + 1) % 3;
+                mvprintw(12, 16, "%-13s",
+                         precision_names[default_context.precision]);
+                move(12, 10);
+                break;
+            case 2:
+                if (derive) {
+                    ret = core_derivative(x, &dual);
+                    res = dual.value;
                 } else {
+                    ret = core_evaluate(x, &res);
+                }
+                if (ret) {
                     mvprintw(10, 0, "Result: %13s", "Error");
+                } else if (derive) {
+                    mvprintw(10, 0, "Result: %+.6E f' %+.6E f'' %+.6E",
+                             res, dual.first, dual.second);
+                } else {
+                    mvprintw(10, 0, "Result: %+.6E", res);
                 }
                 getch();
-                mvprintw(10, 0, "%21s", " ");
+                mvprintw(10, 0, "%56s", " ");
                 move(11 + selection[level], 10);
                 break;
             }
@@ -835,14 +1131,35 @@ int controller_handle(void) {
                 move(13, 16);
                 break;
             case 3:
-                ret = core_integrate(start, end, chunk, &res);
-                if (!ret) {
-                    mvprintw(10, 0, "Result: %+.6E", res);
+                default_context.rule = (default_context.rule + 1) % 8;
+                mvprintw(14, 16, "%-13s", rule_names[default_context.rule]);
+                move(14, 10);
+                break;
+            case 4:
+                default_context.precision = (default_context.precision + 1) % 3;
+                mvprintw(15, 16, "%-13s",
+                         precision_names[default_context.precision]);
+                move(15, 10);
+                break;
+            case 5:
+                if (default_context.rule == RULE_ADAPTIVE) {
+                    ret = core_integrate_adaptive(start, end,
+                                                  default_context.abs_tol,
+                                                  default_context.rel_tol,
+                                                  default_context.limit,
+                                                  &res, &err);
                 } else {
+                    ret = core_integrate(start, end, chunk, &res);
+                }
+                if (ret) {
                     mvprintw(10, 0, "Result: %13s", "Error");
+                } else if (default_context.rule == RULE_ADAPTIVE) {
+                    mvprintw(10, 0, "Result: %+.6E Error: %.1E", res, err);
+                } else {
+                    mvprintw(10, 0, "Result: %+.6E", res);
                 }
                 getch();
-                mvprintw(10, 0, "%21s", " ");
+                mvprintw(10, 0, "%37s", " ");
                 move(11 + selection[level], 10);
                 break;
             }
@@ -879,7 +1196,19 @@ int controller_handle(void) {
                 move(12, 16);
                 break;
             case 2:
-                plot();
+                default_context.precision = (default_context.precision + 1) % 3;
+                mvprintw(13, 16, "%-13s",
+                         precision_names[default_context.precision]);
+                move(13, 10);
+                break;
+            case 3:
+                if (search == 3) {
+                    fit();
+                } else if (search) {
+                    show_found();
+                } else {
+                    plot();
+                }
                 break;
             }
             break;
@@ -957,6 +1286,7 @@ int controller_handle(void) {
             selection[level] = 0;
             --level;
             x = 0;
+            derive = 0;
             remove_evaluate();
             move(11 + selection[level], 0);
             break;
@@ -1005,6 +1335,7 @@ int controller_handle(void) {
             start = 0;
             end = 0;
             chunk = 0;
+            search = 0;
             remove_plot();
             move(11 + selection[level], 0);
             break;
@@ -1,8 +1,29 @@
+#include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#include <float.h>
 #include "core.h"
+#include "../optimizer/optimizer.h"
+#include "../cse/cse.h"
+#include "../pool/pool.h"
+#include "../stats/stats.h"
+#include "../vmath/vmath.h"
+#include "../precision/precision.h"
+
+#define LEAF 4096
 
 double pi = 3.14159265358979323846;
 struct Symbol expression[100];
+struct Context default_context = {
+    .program = { .status = 3 },
+    .use_jit = 1,
+    .use_optimizer = 1,
+    .memo = { .limit = MEMO_LIMIT },
+    .polynomial = { .degree = -1 },
+    .limit = ADAPTIVE_LIMIT,
+    .abs_tol = 1e-10,
+    .rel_tol = 1e-10
+};
 
 static double add(double a, double b) {
     return a + b;
@@ -20,7 +41,7 @@ static double divide(double a, double b) {
     return a / b;
 }
 
-static double (*unary_lookup[12])(double) = {
+double (*unary_lookup[12])(double) = {
     sqrt,
     exp,
     exp2,
@@ -50,7 +71,7 @@ const char *unary_names[12] = {
     "tanh"
 };
 
-static double (*binary_lookup[5])(double, double) = {
+double (*binary_lookup[5])(double, double) = {
     add,
     subtract,
     multiply,
@@ -66,6 +87,17 @@ const char *binary_names[5] = {
     "^"
 };
 
+const char *rule_names[8] = {
+    "Trapezoid",
+    "Simpson",
+    "Gauss 2",
+    "Gauss 3",
+    "Gauss 4",
+    "Gauss 5",
+    "Romberg",
+    "Adaptive"
+};
+
 const char *type_names[5] = {
     "NOP",
     "Number",
@@ -74,63 +106,1066 @@ const char *type_names[5] = {
     "Input",
 };
 
-int core_evaluate(double in, double *out) {
-    static double stack[100];
-    double *sp = stack;
-    if (!out) {
-        return 1;
-    }
-    struct Symbol *ii = expression;
+static char same(double a, double b) {
+    return a == b || (isnan(a) && isnan(b));
+}
+
+void core_context_initialize(struct Context *context) {
+    memset(context, 0, sizeof(struct Context));
+    context->program.status = 3;
+    context->use_jit = 1;
+    context->use_optimizer = 1;
+    context->memo.limit = MEMO_LIMIT;
+    context->polynomial.degree = -1;
+    context->limit = ADAPTIVE_LIMIT;
+    context->abs_tol = 1e-10;
+    context->rel_tol = 1e-10;
+}
+
+void core_context_finalize(struct Context *context) {
+    jit_release(&context->jit);
+    aot_release(&context->aot);
+    memo_release(&context->memo);
+    chebyshev_release(&context->chebyshev);
+    free(context->scratch);
+    context->scratch = NULL;
+    context->scratch_size = 0;
+    context->polynomial.degree = -1;
+    context->aot_pending = 0;
+}
+
+int core_context_compile(struct Context *context,
+                         const struct Symbol *expression) {
+    struct Program *program = &context->program;
+    unsigned char *op = program->ops;
+    double *constant = program->constants;
+    unsigned char depth = 0;
+    program->length = 0;
+    program->depth = 0;
+    program->status = 0;
+    program->removed = 0;
+    program->shared = 0;
+    core_context_finalize(context);
+    const struct Symbol *ii = expression;
     for (char i = 0; i < 100; ++i, ++ii) {
         switch (ii->type) {
         case NUMBER:
-            *(sp++) = ii->data.number;
+            *(op++) = OP_NUMBER;
+            *(constant++) = ii->data.number;
+            ++depth;
             break;
         case UNARY:
-            if (sp == stack) {
-                return 2;
+            if (!depth) {
+                program->status = 2;
+                return program->status;
             }
-            sp[-1] = unary_lookup[ii->data.unary](sp[-1]);
+            *(op++) = OP_UNARY + ii->data.unary;
             break;
         case BINARY:
-            if (sp - stack < 2) {
-                return 2;
+            if (depth < 2) {
+                program->status = 2;
+                return program->status;
             }
-            sp[-2] = binary_lookup[ii->data.binary](sp[-2], sp[-1]);
-            --sp;
+            *(op++) = OP_BINARY + ii->data.binary;
+            --depth;
             break;
         case INPUT:
-            *(sp++) = in;
+            *(op++) = OP_INPUT;
+            ++depth;
             break;
+        default:
+            continue;
         }
+        if (depth > program->depth) {
+            program->depth = depth;
+        }
+    }
+    if (!depth) {
+        program->status = 3;
+        return program->status;
     }
-    if (sp == stack) {
-        return 3;
+    program->length = op - program->ops;
+    if (context->use_optimizer) {
+        optimizer_run(program);
     }
-    *out = sp[-1];
+    cse_run(program);
+    vm_compile(&context->vm, program);
+    polynomial_compile(&context->polynomial, program);
+    memo_compile(&context->memo, program, context->math);
+    memcpy(context->registers,
+           program->pool,
+           program->pinned * sizeof(double));
+    if (context->use_jit && context->math == MATH_STRICT) {
+        jit_compile(&context->jit, program, context->math);
+    }
+    context->aot_pending = context->use_aot &&
+                           context->math == MATH_STRICT;
     return 0;
 }
 
-int core_integrate(double from, double to, unsigned long chunk, double *out) {
+static void interpret(struct Context *context, double in, double *out) {
+    *out = vm_run(&context->vm, context->math, context->registers, in);
+}
+
+static double (*prepare(struct Context *context))(double) {
+    if (context->aot_pending) {
+        context->aot_pending = 0;
+        aot_compile(&context->aot, &context->program);
+    }
+    return context->aot.function ?
+           context->aot.function :
+           context->jit.function;
+}
+
+static char expanded(const struct Context *context) {
+    return context->polynomial.degree >= 0 && !context->verify;
+}
+
+static char horner(const struct Context *context) {
+    return expanded(context) && context->precision == PRECISION_DOUBLE;
+}
+
+static char tabulated(const struct Context *context, double in) {
+    return context->chebyshev.coefficients &&
+           context->precision == PRECISION_DOUBLE &&
+           in >= context->chebyshev.from &&
+           in <= context->chebyshev.to;
+}
+
+int core_context_evaluate(struct Context *context, double in, double *out) {
+    double (*function)(double);
+    double check, bound;
     if (!out) {
         return 1;
     }
-    if (from > to)  {
+    if (context->program.status) {
+        return context->program.status;
+    }
+    if (horner(context)) {
+        *out = polynomial_evaluate(&context->polynomial, in, &bound);
+        if (polynomial_stable(*out, bound)) {
+            return 0;
+        }
+    }
+    if (tabulated(context, in)) {
+        *out = chebyshev_evaluate(&context->chebyshev, in);
+        return 0;
+    }
+    if (context->precision != PRECISION_DOUBLE) {
+        precision_evaluate_batch(&context->program, context->precision,
+                                 context->math, &context->columns,
+                                 &in, out, 1);
+        STATS_RESULTS(out, 1);
+        return 0;
+    }
+    if (!context->verify && memo_lookup(&context->memo, in, out)) {
+        return 0;
+    }
+    function = prepare(context);
+    if (function) {
+        *out = function(in);
+    } else if (context->math != MATH_STRICT) {
+        precision_evaluate_batch(&context->program, PRECISION_DOUBLE,
+                                 context->math, &context->columns,
+                                 &in, out, 1);
+    } else {
+        interpret(context, in, out);
+        STATS_RESULTS(out, 1);
+        memo_insert(&context->memo, in, *out);
+        return 0;
+    }
+    STATS_RESULTS(out, 1);
+    if (context->verify) {
+        interpret(context, in, &check);
+        if (!same(*out, check)) {
+            return 4;
+        }
+        return 0;
+    }
+    memo_insert(&context->memo, in, *out);
+    return 0;
+}
+
+int core_context_derivative(struct Context *context,
+                            double in,
+                            struct Dual *out) {
+    if (!out) {
+        return 1;
+    }
+    if (context->program.status) {
+        return context->program.status;
+    }
+    if (tabulated(context, in)) {
+        chebyshev_derivative(&context->chebyshev, in, out);
+        return 0;
+    }
+    dual_evaluate(&context->program, context->math, in, out);
+    return 0;
+}
+
+int core_context_bound(struct Context *context,
+                       double from,
+                       double to,
+                       struct Bounds *out) {
+    double slack = 0, magnitude;
+    if (!out) {
+        return 1;
+    }
+    if (from > to) {
         return 2;
     }
-    double ii = from;
-    double step = (to - from) / chunk;
-    double sum = 0;
-    double temp1, temp2;
+    if (context->program.status) {
+        return context->program.status + 1;
+    }
+    if (context->precision == PRECISION_FLOAT) {
+        return 5;
+    }
+    interval_evaluate(&context->program, from, to, out);
+    if (horner(context)) {
+        polynomial_evaluate(&context->polynomial,
+                            fmax(fabs(from), fabs(to)), &magnitude);
+        slack = 2 * (context->polynomial.degree + 1) * DBL_EPSILON *
+                magnitude;
+    }
+    if (context->chebyshev.coefficients &&
+        context->precision == PRECISION_DOUBLE &&
+        from <= context->chebyshev.to && to >= context->chebyshev.from) {
+        slack = fmax(slack, context->chebyshev.error);
+    }
+    out->lo -= slack;
+    out->hi += slack;
+    return 0;
+}
+
+static int evaluate_program(struct Context *context,
+                            union Columns *columns,
+                            const double *in,
+                            double *out,
+                            size_t n) {
+    double (*function)(double) = context->aot.function ?
+                                 context->aot.function :
+                                 context->jit.function;
+    double check[BLOCK];
+    size_t len;
+    if (!function || context->precision != PRECISION_DOUBLE) {
+        precision_evaluate_batch(&context->program, context->precision,
+                                 context->math, columns, in, out, n);
+        STATS_RESULTS(out, n);
+        if (!context->verify || context->precision != PRECISION_DOUBLE) {
+            return 0;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            interpret(context, in[i], check);
+            if (!same(out[i], *check)) {
+                return 4;
+            }
+        }
+        return 0;
+    }
+    if (context->aot.batch) {
+        context->aot.batch(in, out, n);
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = function(in[i]);
+        }
+    }
+    STATS_RESULTS(out, n);
+    if (!context->verify) {
+        return 0;
+    }
+    for (size_t base = 0; base < n; base += len) {
+        len = n - base < BLOCK ? n - base : BLOCK;
+        precision_evaluate_batch(&context->program, PRECISION_DOUBLE,
+                                 context->math, columns,
+                                 in + base, check, len);
+        for (size_t j = 0; j < len; ++j) {
+            if (!same(out[base + j], check[j])) {
+                return 4;
+            }
+        }
+    }
+    return 0;
+}
+
+static int evaluate_tabulated(struct Context *context,
+                              union Columns *columns,
+                              const double *in,
+                              double *out,
+                              size_t n) {
+    double xs[BLOCK], ys[BLOCK], ts[BLOCK], zs[BLOCK];
+    size_t index[BLOCK], inside[BLOCK];
+    size_t i = 0, misses, hits;
+    int ret;
+    if (!context->chebyshev.coefficients ||
+        context->precision != PRECISION_DOUBLE) {
+        return evaluate_program(context, columns, in, out, n);
+    }
+    while (i < n) {
+        for (misses = 0, hits = 0; i < n && misses + hits < BLOCK; ++i) {
+            if (tabulated(context, in[i])) {
+                inside[hits] = i;
+                ts[hits++] = in[i];
+            } else {
+                index[misses] = i;
+                xs[misses++] = in[i];
+            }
+        }
+        chebyshev_evaluate_batch(&context->chebyshev, ts, zs, hits);
+        for (size_t j = 0; j < hits; ++j) {
+            out[inside[j]] = zs[j];
+        }
+        if (!misses) {
+            continue;
+        }
+        ret = evaluate_program(context, columns, xs, ys, misses);
+        if (ret) {
+            return ret;
+        }
+        for (size_t j = 0; j < misses; ++j) {
+            out[index[j]] = ys[j];
+        }
+    }
+    return 0;
+}
+
+static int evaluate_batch(struct Context *context,
+                          union Columns *columns,
+                          const double *in,
+                          double *out,
+                          size_t n) {
+    double values[BLOCK], bounds[BLOCK], xs[BLOCK], ys[BLOCK];
+    size_t index[BLOCK];
+    size_t len, misses;
+    int ret;
+    if (!horner(context)) {
+        return evaluate_tabulated(context, columns, in, out, n);
+    }
+    for (size_t base = 0; base < n; base += len) {
+        len = n - base < BLOCK ? n - base : BLOCK;
+        polynomial_evaluate_batch(&context->polynomial, in + base,
+                                  values, bounds, len);
+        misses = 0;
+        for (size_t j = 0; j < len; ++j) {
+            if (!polynomial_stable(values[j], bounds[j])) {
+                index[misses] = base + j;
+                xs[misses++] = in[base + j];
+            }
+        }
+        memcpy(out + base, values, len * sizeof(double));
+        if (!misses) {
+            continue;
+        }
+        ret = evaluate_tabulated(context, columns, xs, ys, misses);
+        if (ret) {
+            return ret;
+        }
+        for (size_t j = 0; j < misses; ++j) {
+            out[index[j]] = ys[j];
+        }
+    }
+    return 0;
+}
+
+static int evaluate_memo(struct Context *context,
+                         const double *in,
+                         double *out,
+                         size_t n) {
+    double xs[BLOCK], ys[BLOCK];
+    size_t index[BLOCK];
+    size_t i = 0, misses;
+    int ret;
+    if (!context->memo.program || !context->memo.limit || context->verify ||
+        context->chebyshev.coefficients || expanded(context) ||
+        context->precision != PRECISION_DOUBLE) {
+        return evaluate_batch(context, &context->columns, in, out, n);
+    }
+    while (i < n) {
+        for (misses = 0; i < n && misses < BLOCK; ++i) {
+            if (!memo_lookup(&context->memo, in[i], out + i)) {
+                index[misses] = i;
+                xs[misses++] = in[i];
+            }
+        }
+        if (!misses) {
+            continue;
+        }
+        ret = evaluate_batch(context, &context->columns, xs, ys, misses);
+        if (ret) {
+            return ret;
+        }
+        for (size_t j = 0; j < misses; ++j) {
+            out[index[j]] = ys[j];
+            memo_insert(&context->memo, xs[j], ys[j]);
+        }
+    }
+    return 0;
+}
+
+int core_context_evaluate_batch(struct Context *context,
+                                const double *in,
+                                double *out,
+                                size_t n) {
+    if (!in || !out) {
+        return 1;
+    }
+    if (context->program.status) {
+        return context->program.status;
+    }
+    prepare(context);
+    return evaluate_memo(context, in, out, n);
+}
+
+struct Parallel {
+    struct Context *context;
+    const double *in;
+    double *out;
+    size_t n;
+    int *errors;
+};
+
+static int reserve_columns(struct Context *context) {
+    unsigned int workers = pool_threads() - 1;
+    union Columns *scratch;
+    if (workers <= context->scratch_size) {
+        return 0;
+    }
+    scratch = realloc(context->scratch, workers * sizeof(union Columns));
+    if (!scratch) {
+        return 1;
+    }
+    context->scratch = scratch;
+    context->scratch_size = workers;
+    return 0;
+}
+
+static union Columns *worker_columns(struct Context *context) {
+    unsigned int worker = pool_worker();
+    return worker ? context->scratch + worker - 1 : &context->columns;
+}
+
+static void evaluate_leaf(void *arg, unsigned long index) {
+    struct Parallel *job = arg;
+    size_t first = index * LEAF;
+    size_t len = job->n - first < LEAF ? job->n - first : LEAF;
+    job->errors[index] = evaluate_batch(job->context,
+                                        worker_columns(job->context),
+                                        job->in + first,
+                                        job->out + first,
+                                        len);
+}
+
+int core_context_evaluate_parallel(struct Context *context,
+                                   const double *in,
+                                   double *out,
+                                   size_t n) {
+    struct Parallel job;
+    unsigned long leaves = (n + LEAF - 1) / LEAF;
+    int ret = 0;
+    if (!in || !out) {
+        return 1;
+    }
+    if (context->program.status) {
+        return context->program.status;
+    }
+    if (!n) {
+        return 0;
+    }
+    prepare(context);
+    pool_initialize(context->threads);
+    if (reserve_columns(context)) {
+        return 1;
+    }
+    job.context = context;
+    job.in = in;
+    job.out = out;
+    job.n = n;
+    job.errors = malloc(leaves * sizeof(int));
+    if (!job.errors) {
+        return 1;
+    }
+    pool_run(evaluate_leaf, &job, leaves);
+    for (unsigned long i = 0; i < leaves && !ret; ++i) {
+        ret = job.errors[i];
+    }
+    free(job.errors);
+    return ret;
+}
+
+static int sample_program(void *arg, const double *in, double *out, size_t n) {
+    struct Context *context = arg;
+    return evaluate_program(context, &context->columns, in, out, n);
+}
+
+int core_context_tabulate(struct Context *context, double from, double to) {
+    if (context->program.status) {
+        return context->program.status + 1;
+    }
+    prepare(context);
+    return chebyshev_fit(&context->chebyshev, sample_program, context,
+                         from, to);
+}
+
+static const double gauss_nodes[4][5] = {
+    {
+        -0.5773502691896257645, 0.5773502691896257645
+    },
+    {
+        -0.7745966692414833770, 0, 0.7745966692414833770
+    },
+    {
+        -0.8611363115940525752, -0.3399810435848562648,
+        0.3399810435848562648, 0.8611363115940525752
+    },
+    {
+        -0.9061798459386639928, -0.5384693101056830910, 0,
+        0.5384693101056830910, 0.9061798459386639928
+    }
+};
+
+static const double gauss_weights[4][5] = {
+    {
+        1, 1
+    },
+    {
+        0.5555555555555555556, 0.8888888888888888889, 0.5555555555555555556
+    },
+    {
+        0.3478548451374538574, 0.6521451548625461427,
+        0.6521451548625461427, 0.3478548451374538574
+    },
+    {
+        0.2369268850561890875, 0.4786286704993664680, 0.5688888888888888889,
+        0.4786286704993664680, 0.2369268850561890875
+    }
+};
+
+#define RULE_MIDPOINT -1
+
+struct Integration {
+    struct Context *context;
+    int rule;
+    double from;
+    double to;
+    double step;
+    unsigned long units;
+    double *sums;
+    int *errors;
+};
+
+static unsigned long leaf_points(const struct Integration *job,
+                                 unsigned long first,
+                                 unsigned long last) {
+    switch (job->rule) {
+    case RULE_TRAPEZOID:
+    case RULE_SIMPSON:
+        return last - first + 1;
+    case RULE_MIDPOINT:
+        return last - first;
+    default:
+        return (last - first) * (job->rule - RULE_GAUSS2 + 2);
+    }
+}
+
+static void leaf_point(const struct Integration *job,
+                       unsigned long first,
+                       unsigned long last,
+                       unsigned long p,
+                       double *x,
+                       double *w) {
+    unsigned long n, i;
+    switch (job->rule) {
+    case RULE_TRAPEZOID:
+        i = first + p;
+        *x = i == job->units ? job->to : job->from + i * job->step;
+        *w = i == first || i == last ? job->step / 2 : job->step;
+        break;
+    case RULE_SIMPSON:
+        i = first + p;
+        *x = i == job->units ? job->to : job->from + i * job->step;
+        *w = job->step / 3 * (i == first || i == last ? 1 : p % 2 ? 4 : 2);
+        break;
+    case RULE_MIDPOINT:
+        *x = job->from + (2 * (first + p) + 1) * job->step;
+        *w = 1;
+        break;
+    default:
+        n = job->rule - RULE_GAUSS2 + 2;
+        i = first + p / n;
+        *x = job->from + (i + 0.5) * job->step +
+             0.5 * job->step * gauss_nodes[n - 2][p % n];
+        *w = 0.5 * job->step * gauss_weights[n - 2][p % n];
+        break;
+    }
+}
+
+static void integrate_leaf(void *arg, unsigned long index) {
+    struct Integration *job = arg;
+    union Columns *columns = worker_columns(job->context);
+    double xs[BLOCK], ws[BLOCK], ys[BLOCK];
+    unsigned long first = index * LEAF;
+    unsigned long last = first + LEAF < job->units ? first + LEAF : job->units;
+    unsigned long points = leaf_points(job, first, last);
+    unsigned long len;
+    double sum = 0, carry = 0, term;
     int ret;
-    for (unsigned long i = 0; i < chunk; ++i, ii += step) {
-        ret = core_evaluate(ii, &temp1);
+    for (unsigned long p = 0; p < points; p += len) {
+        len = points - p < BLOCK ? points - p : BLOCK;
+        for (unsigned long j = 0; j < len; ++j) {
+            leaf_point(job, first, last, p + j, xs + j, ws + j);
+        }
+        ret = evaluate_batch(job->context, columns, xs, ys, len);
         if (ret) {
+            job->errors[index] = ret;
+            return;
+        }
+        if (job->context->precision != PRECISION_DOUBLE_DOUBLE) {
+            for (unsigned long j = 0; j < len; ++j) {
+                sum += ws[j] * ys[j];
+            }
+            continue;
+        }
+        for (unsigned long j = 0; j < len; ++j) {
+            term = ws[j] * ys[j];
+            carry += fabs(sum) >= fabs(term) ?
+                     (sum - (sum + term)) + term :
+                     (term - (sum + term)) + sum;
+            sum += term;
+        }
+    }
+    job->sums[index] = sum + carry;
+    job->errors[index] = 0;
+}
+
+static double pairwise_sum(const double *values, unsigned long n) {
+    if (n == 1) {
+        return values[0];
+    }
+    return pairwise_sum(values, n / 2) +
+           pairwise_sum(values + n / 2, n - n / 2);
+}
+
+static int integrate_units(struct Context *context,
+                           int rule,
+                           double from,
+                           double to,
+                           double step,
+                           unsigned long units,
+                           double *out) {
+    struct Integration job;
+    unsigned long leaves = (units + LEAF - 1) / LEAF;
+    int ret = 0;
+    job.context = context;
+    job.rule = rule;
+    job.from = from;
+    job.to = to;
+    job.step = step;
+    job.units = units;
+    job.sums = malloc(leaves * sizeof(double));
+    job.errors = malloc(leaves * sizeof(int));
+    if (!job.sums || !job.errors) {
+        free(job.sums);
+        free(job.errors);
+        return 1;
+    }
+    pool_run(integrate_leaf, &job, leaves);
+    for (unsigned long i = 0; i < leaves && !ret; ++i) {
+        ret = job.errors[i];
+    }
+    if (!ret) {
+        *out = pairwise_sum(job.sums, leaves);
+    }
+    free(job.sums);
+    free(job.errors);
+    return ret;
+}
+
+static int romberg(struct Context *context,
+                   double from,
+                   double to,
+                   unsigned long chunk,
+                   double *out) {
+    double previous[32], current[32];
+    double ends[2] = { from, to };
+    double ys[2];
+    double mid, factor;
+    double h = to - from;
+    int ret;
+    int k;
+    ret = evaluate_batch(context, &context->columns, ends, ys, 2);
+    if (ret) {
+        return ret;
+    }
+    previous[0] = h / 2 * (ys[0] + ys[1]);
+    for (k = 1; k < 32 && (1UL << k) <= chunk; ++k) {
+        h /= 2;
+        ret = integrate_units(context, RULE_MIDPOINT,
+                              from, to, h, 1UL << (k - 1), &mid);
+        if (ret) {
+            return ret;
+        }
+        current[0] = previous[0] / 2 + h * mid;
+        factor = 1;
+        for (int j = 1; j <= k; ++j) {
+            factor *= 4;
+            current[j] = current[j - 1] +
+                         (current[j - 1] - previous[j - 1]) / (factor - 1);
+        }
+        if (k > 4 &&
+            fabs(current[k] - previous[k - 1]) <= 1e-15 * fabs(current[k])) {
+            *out = current[k];
+            return 0;
+        }
+        memcpy(previous, current, (k + 1) * sizeof(double));
+    }
+    *out = previous[k - 1];
+    return 0;
+}
+
+static const double kronrod_nodes[8] = {
+    0.991455371120812639206854697526329,
+    0.949107912342758524526189684047851,
+    0.864864423359769072789712788640926,
+    0.741531185599394439863864773280788,
+    0.586087235467691130294144845693013,
+    0.405845151377397166906606412076961,
+    0.207784955007898467600689403773245,
+    0
+};
+
+static const double kronrod_weights[8] = {
+    0.022935322010529224963732008058970,
+    0.063092092629978553290700663189204,
+    0.104790010322250183839876322541518,
+    0.140653259715525918745189590510238,
+    0.169004726639267902826583426598550,
+    0.190350578064785409913256402421014,
+    0.204432940075298892414161999234649,
+    0.209482141084727828012999174891714
+};
+
+static const double gauss7_weights[4] = {
+    0.129484966168869693270611432679082,
+    0.279705391489276667901467771423780,
+    0.381830050505118944950369775488975,
+    0.417959183673469387755102040816327
+};
+
+struct Interval {
+    double from;
+    double to;
+    double result;
+    double error;
+};
+
+static void kronrod_points(double from, double to, double *xs) {
+    double center = (from + to) / 2;
+    double half = (to - from) / 2;
+    xs[0] = center;
+    for (int j = 0; j < 7; ++j) {
+        xs[1 + 2 * j] = center - half * kronrod_nodes[j];
+        xs[2 + 2 * j] = center + half * kronrod_nodes[j];
+    }
+}
+
+static void kronrod_estimate(struct Interval *interval,
+                             const double *ys,
+                             double epsilon) {
+    double half = (interval->to - interval->from) / 2;
+    double gauss = ys[0] * gauss7_weights[3];
+    double kronrod = ys[0] * kronrod_weights[7];
+    double absolute = fabs(kronrod);
+    double mean, spread, error;
+    for (int j = 0; j < 7; ++j) {
+        double pair = ys[1 + 2 * j] + ys[2 + 2 * j];
+        kronrod += kronrod_weights[j] * pair;
+        absolute += kronrod_weights[j] *
+                    (fabs(ys[1 + 2 * j]) + fabs(ys[2 + 2 * j]));
+        if (j % 2) {
+            gauss += gauss7_weights[j / 2] * pair;
+        }
+    }
+    mean = kronrod / 2;
+    spread = kronrod_weights[7] * fabs(ys[0] - mean);
+    for (int j = 0; j < 7; ++j) {
+        spread += kronrod_weights[j] *
+                  (fabs(ys[1 + 2 * j] - mean) + fabs(ys[2 + 2 * j] - mean));
+    }
+    interval->result = kronrod * half;
+    absolute *= fabs(half);
+    spread *= fabs(half);
+    error = fabs((kronrod - gauss) * half);
+    if (spread != 0 && error != 0) {
+        error = spread * fmin(1, pow(200 * error / spread, 1.5));
+    }
+    error = fmax(50 * epsilon * absolute, error);
+    interval->error = isnan(error) ? INFINITY : error;
+}
+
+static char interval_prune(struct Context *context,
+                           struct Interval *interval,
+                           double tolerance) {
+    struct Bounds bounds;
+    double width = interval->to - interval->from;
+    double error;
+    interval_evaluate(&context->program, interval->from, interval->to,
+                      &bounds);
+    error = (bounds.hi - bounds.lo) * width / 2;
+    if (!isfinite(error) || error > tolerance * width / 4) {
+        return 0;
+    }
+    interval->result = (bounds.hi + bounds.lo) * width / 2;
+    interval->error = error;
+    return 1;
+}
+
+static void heap_push(struct Interval *heap,
+                      unsigned long size,
+                      struct Interval interval) {
+    unsigned long i = size;
+    for (; i && heap[(i - 1) / 2].error < interval.error; i = (i - 1) / 2) {
+        heap[i] = heap[(i - 1) / 2];
+    }
+    heap[i] = interval;
+}
+
+static struct Interval heap_pop(struct Interval *heap, unsigned long size) {
+    struct Interval top = heap[0];
+    struct Interval last = heap[size - 1];
+    unsigned long i = 0, child;
+    --size;
+    for (; (child = 2 * i + 1) < size; i = child) {
+        if (child + 1 < size && heap[child + 1].error > heap[child].error) {
+            ++child;
+        }
+        if (heap[child].error <= last.error) {
+            break;
+        }
+        heap[i] = heap[child];
+    }
+    heap[i] = last;
+    return top;
+}
+
+static char integrate_exact(const struct Context *context,
+                            double from,
+                            double to,
+                            double abs_tol,
+                            double rel_tol,
+                            double *out,
+                            double *error) {
+    double result;
+    if (!expanded(context)) {
+        return 0;
+    }
+    result = polynomial_integral(&context->polynomial, from, to, error);
+    if (!(*error <= fmax(abs_tol, rel_tol * fabs(result)))) {
+        return 0;
+    }
+    *out = result;
+    return 1;
+}
+
+int core_context_integrate_adaptive(struct Context *context,
+                                    double from,
+                                    double to,
+                                    double abs_tol,
+                                    double rel_tol,
+                                    unsigned long limit,
+                                    double *out,
+                                    double *error) {
+    struct Interval *heap;
+    struct Interval worst, halves[2];
+    struct Interval *evaluated[2];
+    double xs[30], ys[30];
+    double result, total, tolerance;
+    double epsilon = DBL_EPSILON;
+    int pending;
+    unsigned long size = 0;
+    int ret;
+    if (!out || !error) {
+        return 1;
+    }
+    if (from > to)  {
+        return 2;
+    }
+    if (context->program.status) {
+        return context->program.status + 1;
+    }
+    if (!limit) {
+        limit = 1;
+    }
+    if (integrate_exact(context, from, to, abs_tol, rel_tol, out, error)) {
+        return 0;
+    }
+    if (context->precision == PRECISION_FLOAT) {
+        epsilon = FLT_EPSILON;
+        rel_tol = fmax(rel_tol, 100 * epsilon);
+    }
+    if (tabulated(context, from) && tabulated(context, to)) {
+        *out = chebyshev_integral(&context->chebyshev, from, to);
+        *error = context->chebyshev.error * (to - from);
+        return 0;
+    }
+    prepare(context);
+    heap = malloc(limit * sizeof(struct Interval));
+    if (!heap) {
+        return 1;
+    }
+    halves[0].from = from;
+    halves[0].to = to;
+    kronrod_points(from, to, xs);
+    ret = evaluate_memo(context, xs, ys, 15);
+    if (ret) {
+        free(heap);
+        return ret + 1;
+    }
+    kronrod_estimate(halves, ys, epsilon);
+    heap_push(heap, size++, halves[0]);
+    result = halves[0].result;
+    total = halves[0].error;
+    while (size < limit && total > fmax(abs_tol, rel_tol * fabs(result))) {
+        worst = heap_pop(heap, size--);
+        halves[0].from = worst.from;
+        halves[0].to = (worst.from + worst.to) / 2;
+        halves[1].from = halves[0].to;
+        halves[1].to = worst.to;
+        tolerance = fmax(abs_tol, rel_tol * fabs(result)) / (to - from);
+        pending = 0;
+        for (int h = 0; h < 2; ++h) {
+            if (!interval_prune(context, halves + h, tolerance)) {
+                kronrod_points(halves[h].from, halves[h].to,
+                               xs + 15 * pending);
+                evaluated[pending++] = halves + h;
+            }
+        }
+        ret = evaluate_memo(context, xs, ys, 15 * pending);
+        if (ret) {
+            free(heap);
             return ret + 1;
         }
-        ret = core_evaluate(ii + step, &temp2);
-        sum += (temp1 + temp2) * step / 2;
+        for (int h = 0; h < pending; ++h) {
+            kronrod_estimate(evaluated[h], ys + 15 * h, epsilon);
+        }
+        heap_push(heap, size++, halves[0]);
+        heap_push(heap, size++, halves[1]);
+        result += halves[0].result + halves[1].result - worst.result;
+        total += halves[0].error + halves[1].error - worst.error;
     }
-    *out = sum;
+    result = 0;
+    total = 0;
+    for (unsigned long i = 0; i < size; ++i) {
+        result += heap[i].result;
+        total += heap[i].error;
+    }
+    *out = result;
+    *error = total;
+    free(heap);
     return 0;
 }
+
+int core_context_integrate(struct Context *context,
+                           double from,
+                           double to,
+                           unsigned long chunk,
+                           double *out) {
+    double error;
+    int ret;
+    STATS_TIMER(begin);
+    if (!out) {
+        return 1;
+    }
+    if (from > to)  {
+        return 2;
+    }
+    if (context->program.status) {
+        return context->program.status + 1;
+    }
+    if (!chunk && context->rule != RULE_ADAPTIVE) {
+        *out = 0;
+        return 0;
+    }
+    if (integrate_exact(context, from, to,
+                        context->abs_tol, context->rel_tol, out, &error)) {
+        STATS_ELAPSED(integrate_seconds, integrations, begin);
+        return 0;
+    }
+    if (tabulated(context, from) && tabulated(context, to)) {
+        *out = chebyshev_integral(&context->chebyshev, from, to);
+        STATS_ELAPSED(integrate_seconds, integrations, begin);
+        return 0;
+    }
+    if (context->rule == RULE_ADAPTIVE) {
+        ret = core_context_integrate_adaptive(context, from, to,
+                                              context->abs_tol,
+                                              context->rel_tol,
+                                              context->limit, out, &error);
+        STATS_ELAPSED(integrate_seconds, integrations, begin);
+        return ret;
+    }
+    prepare(context);
+    pool_initialize(context->threads);
+    if (reserve_columns(context)) {
+        return 1;
+    }
+    switch (context->rule) {
+    case RULE_ROMBERG:
+        ret = romberg(context, from, to, chunk, out);
+        break;
+    case RULE_SIMPSON:
+        chunk += chunk % 2;
+        ret = integrate_units(context, context->rule,
+                              from, to, (to - from) / chunk, chunk, out);
+        break;
+    default:
+        ret = integrate_units(context, context->rule,
+                              from, to, (to - from) / chunk, chunk, out);
+        break;
+    }
+    STATS_ELAPSED(integrate_seconds, integrations, begin);
+    return ret ? ret + 1 : 0;
+}
+
+int core_compile(void) {
+    return core_context_compile(&default_context, expression);
+}
+
+int core_evaluate(double in, double *out) {
+    return core_context_evaluate(&default_context, in, out);
+}
+
+int core_evaluate_batch(const double *in, double *out, size_t n) {
+    return core_context_evaluate_batch(&default_context, in, out, n);
+}
+
+int core_evaluate_parallel(const double *in, double *out, size_t n) {
+    return core_context_evaluate_parallel(&default_context, in, out, n);
+}
+
+int core_derivative(double in, struct Dual *out) {
+    return core_context_derivative(&default_context, in, out);
+}
+
+int core_bound(double from, double to, struct Bounds *out) {
+    return core_context_bound(&default_context, from, to, out);
+}
+
+int core_tabulate(double from, double to) {
+    return core_context_tabulate(&default_context, from, to);
+}
+
+int core_integrate(double from, double to, unsigned long chunk, double *out) {
+    return core_context_integrate(&default_context, from, to, chunk, out);
+}
+
+int core_integrate_adaptive(double from,
+                            double to,
+                            double abs_tol,
+                            double rel_tol,
+                            unsigned long limit,
+                            double *out,
+                            double *error) {
+    return core_context_integrate_adaptive(&default_context,
+                                           from, to,
+                                           abs_tol, rel_tol,
+                                           limit, out, error);
+}
@@ -1,12 +1,46 @@
 #ifndef _CORE_H_
 #define _CORE_H_
 
+#include <stddef.h>
+#include "../jit/jit.h"
+#include "../aot/aot.h"
+#include "../memo/memo.h"
+#include "../dual/dual.h"
+#include "../interval/interval.h"
+#include "../chebyshev/chebyshev.h"
+#include "../polynomial/polynomial.h"
+#include "../vm/vm.h"
+
 #define NOP 0
 #define NUMBER 1
 #define UNARY 2
 #define BINARY 3
 #define INPUT 4
 
+#define OP_INPUT 0
+#define OP_NUMBER 1
+#define OP_DUP 2
+#define OP_UNARY 3
+#define OP_BINARY 15
+#define OP_ADD 15
+#define OP_SUBTRACT 16
+#define OP_MULTIPLY 17
+#define OP_DIVIDE 18
+#define OP_POW 19
+
+#define RULE_TRAPEZOID 0
+#define RULE_SIMPSON 1
+#define RULE_GAUSS2 2
+#define RULE_GAUSS3 3
+#define RULE_GAUSS4 4
+#define RULE_GAUSS5 5
+#define RULE_ROMBERG 6
+#define RULE_ADAPTIVE 7
+#define ADAPTIVE_LIMIT 1000
+
+#define REGISTERS 128
+#define BLOCK 64
+
 struct Symbol {
     char type;
     union {
@@ -16,13 +50,117 @@ struct Symbol {
     } data;
 };
 
+struct Program {
+    unsigned char ops[100];
+    double constants[100];
+    unsigned char length;
+    unsigned char depth;
+    unsigned char code[100];
+    unsigned char dst[100];
+    unsigned char a[100];
+    unsigned char b[100];
+    double pool[REGISTERS];
+    unsigned char code_length;
+    unsigned char registers;
+    unsigned char pinned;
+    unsigned char result;
+    int status;
+    int removed;
+    int shared;
+};
+
+/* Column scratch for one block, wide enough for double-double values. */
+union Columns {
+    double doubles[REGISTERS][BLOCK];
+    float floats[REGISTERS][BLOCK];
+    double pairs[REGISTERS][2 * BLOCK];
+};
+
+struct Context {
+    struct Program program;
+    struct Vm vm;
+    struct Jit jit;
+    struct Aot aot;
+    struct Memo memo;
+    struct Chebyshev chebyshev;
+    struct Polynomial polynomial;
+    double registers[REGISTERS];
+    union Columns columns;
+    union Columns *scratch;
+    unsigned int scratch_size;
+    char use_jit;
+    char use_aot;
+    char use_optimizer;
+    char verify;
+    char aot_pending;
+    unsigned int threads;
+    int rule;
+    int math;
+    int precision;
+    unsigned long limit;
+    double abs_tol;
+    double rel_tol;
+};
+
 extern struct Symbol expression[100];
+extern struct Context default_context;
 extern double pi;
+extern double (*unary_lookup[12])(double);
+extern double (*binary_lookup[5])(double, double);
 extern const char *type_names[5];
 extern const char *unary_names[12];
 extern const char *binary_names[5];
+extern const char *rule_names[8];
+
+void core_context_initialize(struct Context *context);
+void core_context_finalize(struct Context *context);
+int core_context_compile(struct Context *context,
+                         const struct Symbol *expression);
+int core_context_evaluate(struct Context *context, double in, double *out);
+int core_context_evaluate_batch(struct Context *context,
+                                const double *in,
+                                double *out,
+                                size_t n);
+int core_context_evaluate_parallel(struct Context *context,
+                                   const double *in,
+                                   double *out,
+                                   size_t n);
+int core_context_derivative(struct Context *context,
+                            double in,
+                            struct Dual *out);
+int core_context_bound(struct Context *context,
+                       double from,
+                       double to,
+                       struct Bounds *out);
+int core_context_tabulate(struct Context *context, double from, double to);
+int core_context_integrate(struct Context *context,
+                           double from,
+                           double to,
+                           unsigned long chunk,
+                           double *out);
+int core_context_integrate_adaptive(struct Context *context,
+                                    double from,
+                                    double to,
+                                    double abs_tol,
+                                    double rel_tol,
+                                    unsigned long limit,
+                                    double *out,
+                                    double *error);
 
+int core_compile(void);
 int core_evaluate(double in, double *out);
+int core_evaluate_batch(const double *in, double *out, size_t n);
+int core_evaluate_parallel(const double *in, double *out, size_t n);
+int core_derivative(double in, struct Dual *out);
+int core_bound(double from, double to, struct Bounds *out);
+int core_tabulate(double from, double to);
 int core_integrate(double from, double to, unsigned long chunk, double *out);
+int core_integrate_adaptive(double from,
+                            double to,
+                            double abs_tol,
+                            double rel_tol,
+                            unsigned long limit,
+                            double *out,
+                            double *error);
 
 #endif
@@ -0,0 +1,167 @@
+#include <stdint.h>
+#include <string.h>
+#include "cse.h"
+
+#define TABLE_SIZE 256
+
+struct Node {
+    unsigned char op;
+    unsigned char a, b;
+    double number;
+    unsigned char last;
+    unsigned char reg;
+    char live;
+};
+
+struct Dag {
+    struct Node nodes[100];
+    unsigned char size;
+    unsigned char table[TABLE_SIZE];
+};
+
+static uint32_t hash_node(unsigned char op,
+                          unsigned char a,
+                          unsigned char b,
+                          double number) {
+    unsigned char bytes[11];
+    uint32_t hash = 0x811c9dc5;
+    bytes[0] = op;
+    bytes[1] = a;
+    bytes[2] = b;
+    memcpy(bytes + 3, &number, 8);
+    for (int i = 0; i < 11; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x01000193;
+    }
+    return hash;
+}
+
+static unsigned char intern(struct Dag *dag,
+                            unsigned char op,
+                            unsigned char a,
+                            unsigned char b,
+                            double number) {
+    unsigned char temp;
+    struct Node *node;
+    if ((op == OP_ADD || op == OP_MULTIPLY) && a > b) {
+        temp = a;
+        a = b;
+        b = temp;
+    }
+    uint32_t slot = hash_node(op, a, b, number) % TABLE_SIZE;
+    for (; dag->table[slot]; slot = (slot + 1) % TABLE_SIZE) {
+        node = dag->nodes + dag->table[slot] - 1;
+        if (node->op == op && node->a == a && node->b == b &&
+            !memcmp(&node->number, &number, sizeof(double))) {
+            return dag->table[slot] - 1;
+        }
+    }
+    node = dag->nodes + dag->size;
+    node->op = op;
+    node->a = a;
+    node->b = b;
+    node->number = number;
+    node->live = 0;
+    dag->table[slot] = ++dag->size;
+    return dag->size - 1;
+}
+
+int cse_run(struct Program *program) {
+    struct Dag dag;
+    unsigned char stack[100];
+    unsigned char *sp = stack;
+    unsigned char free_list[REGISTERS];
+    unsigned char free_count = 0;
+    unsigned char next;
+    unsigned char operations = 0;
+    const double *constant = program->constants;
+    struct Node *node;
+    if (program->status) {
+        return 0;
+    }
+    dag.size = 0;
+    memset(dag.table, 0, TABLE_SIZE);
+    const unsigned char *ops_end = program->ops + program->length;
+    for (const unsigned char *ii = program->ops; ii < ops_end; ++ii) {
+        switch (*ii) {
+        case OP_INPUT:
+            *(sp++) = intern(&dag, OP_INPUT, 0, 0, 0);
+            break;
+        case OP_NUMBER:
+            *(sp++) = intern(&dag, OP_NUMBER, 0, 0, *(constant++));
+            break;
+        case OP_DUP:
+            sp[0] = sp[-1];
+            ++sp;
+            break;
+        default:
+            ++operations;
+            if (*ii >= OP_BINARY) {
+                sp[-2] = intern(&dag, *ii, sp[-2], sp[-1], 0);
+                --sp;
+            } else {
+                sp[-1] = intern(&dag, *ii, sp[-1], 0, 0);
+            }
+            break;
+        }
+    }
+    dag.nodes[sp[-1]].live = 1;
+    for (int i = sp[-1]; i >= 0; --i) {
+        node = dag.nodes + i;
+        if (!node->live || node->op < OP_UNARY) {
+            continue;
+        }
+        dag.nodes[node->a].live = 1;
+        if (node->op >= OP_BINARY) {
+            dag.nodes[node->b].live = 1;
+        }
+    }
+    next = 1;
+    for (unsigned char i = 0; i < dag.size; ++i) {
+        node = dag.nodes + i;
+        if (!node->live) {
+            continue;
+        }
+        switch (node->op) {
+        case OP_INPUT:
+            node->reg = 0;
+            break;
+        case OP_NUMBER:
+            program->pool[next] = node->number;
+            node->reg = next++;
+            break;
+        default:
+            dag.nodes[node->a].last = i;
+            if (node->op >= OP_BINARY) {
+                dag.nodes[node->b].last = i;
+            }
+            break;
+        }
+    }
+    program->pinned = next;
+    program->code_length = 0;
+    for (unsigned char i = 0; i < dag.size; ++i) {
+        node = dag.nodes + i;
+        if (!node->live || node->op < OP_UNARY) {
+            continue;
+        }
+        unsigned char a = dag.nodes[node->a].reg;
+        unsigned char b = node->op >= OP_BINARY ? dag.nodes[node->b].reg : a;
+        if (a >= program->pinned && dag.nodes[node->a].last == i) {
+            free_list[free_count++] = a;
+        }
+        if (b != a && b >= program->pinned && dag.nodes[node->b].last == i) {
+            free_list[free_count++] = b;
+        }
+        node->reg = free_count ? free_list[--free_count] : next++;
+        program->code[program->code_length] = node->op;
+        program->dst[program->code_length] = node->reg;
+        program->a[program->code_length] = a;
+        program->b[program->code_length] = b;
+        ++program->code_length;
+    }
+    program->registers = next;
+    program->result = dag.nodes[sp[-1]].reg;
+    program->shared = operations - program->code_length;
+    return program->shared;
+}
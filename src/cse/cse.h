@@ -0,0 +1,8 @@
+#ifndef _CSE_H_
+#define _CSE_H_
+
+#include "../core/core.h"
+
+int cse_run(struct Program *program);
+
+#endif
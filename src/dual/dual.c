@@ -0,0 +1,133 @@
+#include <math.h>
+#include "../core/core.h"
+#include "dual.h"
+#include "../vmath/vmath.h"
+
+#define LN2 0.693147180559945309417232121458176568
+#define LN10 2.30258509299404568401799145468436421
+
+static struct Dual chain(struct Dual u, double value, double d1, double d2) {
+    struct Dual y;
+    if (u.first == 0 && u.second == 0) {
+        return (struct Dual){ value, 0, 0 };
+    }
+    y.value = value;
+    y.first = d1 * u.first;
+    y.second = d2 * u.first * u.first + d1 * u.second;
+    return y;
+}
+
+static struct Dual unary(int function, int math, struct Dual u) {
+    double v = vmath_scalar[math][function](u.value);
+    double d;
+    switch (function) {
+    case 0:
+        d = 0.5 / v;
+        return chain(u, v, d, -d / (2 * u.value));
+    case 1:
+        return chain(u, v, v, v);
+    case 2:
+        return chain(u, v, LN2 * v, LN2 * LN2 * v);
+    case 3:
+        return chain(u, v, 1 / u.value, -1 / (u.value * u.value));
+    case 4:
+        d = 1 / (LN10 * u.value);
+        return chain(u, v, d, -d / u.value);
+    case 5:
+        d = 1 / (LN2 * u.value);
+        return chain(u, v, d, -d / u.value);
+    case 6:
+        d = vmath_scalar[math][7](u.value);
+        return chain(u, v, d, -v);
+    case 7:
+        d = vmath_scalar[math][6](u.value);
+        return chain(u, v, -d, -v);
+    case 8:
+        d = 1 + v * v;
+        return chain(u, v, d, 2 * v * d);
+    case 9:
+        d = vmath_scalar[math][10](u.value);
+        return chain(u, v, d, v);
+    case 10:
+        d = vmath_scalar[math][9](u.value);
+        return chain(u, v, d, v);
+    default:
+        d = 1 - v * v;
+        return chain(u, v, d, -2 * v * d);
+    }
+}
+
+static struct Dual power(int math, struct Dual a, struct Dual b) {
+    double (*pow_function)(double, double) = vmath_scalar_pow[math];
+    double v = pow_function(a.value, b.value);
+    double l, l1, l2, w1, w2;
+    struct Dual y;
+    if (b.first == 0 && b.second == 0) {
+        return chain(a, v,
+                     b.value * pow_function(a.value, b.value - 1),
+                     b.value * (b.value - 1) *
+                     pow_function(a.value, b.value - 2));
+    }
+    l = vmath_scalar[math][3](a.value);
+    l1 = a.first / a.value;
+    l2 = (a.second - a.first * l1) / a.value;
+    w1 = b.first * l + b.value * l1;
+    w2 = b.second * l + 2 * b.first * l1 + b.value * l2;
+    y.value = v;
+    y.first = v * w1;
+    y.second = v * (w2 + w1 * w1);
+    return y;
+}
+
+static struct Dual binary(int op, int math, struct Dual a, struct Dual b) {
+    struct Dual y;
+    switch (op) {
+    case OP_ADD:
+        y.value = a.value + b.value;
+        y.first = a.first + b.first;
+        y.second = a.second + b.second;
+        return y;
+    case OP_SUBTRACT:
+        y.value = a.value - b.value;
+        y.first = a.first - b.first;
+        y.second = a.second - b.second;
+        return y;
+    case OP_MULTIPLY:
+        y.value = a.value * b.value;
+        y.first = a.first * b.value + a.value * b.first;
+        y.second = a.second * b.value + 2 * a.first * b.first +
+                   a.value * b.second;
+        return y;
+    case OP_DIVIDE:
+        y.value = a.value / b.value;
+        y.first = (a.first - y.value * b.first) / b.value;
+        y.second = (a.second - 2 * y.first * b.first - y.value * b.second) /
+                   b.value;
+        return y;
+    default:
+        return power(math, a, b);
+    }
+}
+
+void dual_evaluate(const struct Program *program,
+                   int math,
+                   double in,
+                   struct Dual *out) {
+    struct Dual registers[REGISTERS];
+    const unsigned char *ii = program->code;
+    registers[0] = (struct Dual){ in, 1, 0 };
+    for (unsigned char r = 1; r < program->pinned; ++r) {
+        registers[r] = (struct Dual){ program->pool[r], 0, 0 };
+    }
+    for (unsigned char i = 0; i < program->code_length; ++i, ++ii) {
+        if (*ii >= OP_BINARY) {
+            registers[program->dst[i]] = binary(*ii, math,
+                                                registers[program->a[i]],
+                                                registers[program->b[i]]);
+        } else {
+            registers[program->dst[i]] = unary(*ii - OP_UNARY, math,
+                                               registers[program->a[i]]);
+        }
+    }
+    *out = registers[program->result];
+}
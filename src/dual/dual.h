@@ -0,0 +1,17 @@
+#ifndef _DUAL_H_
+#define _DUAL_H_
+
+struct Program;
+
+struct Dual {
+    double value;
+    double first;
+    double second;
+};
+
+void dual_evaluate(const struct Program *program,
+                   int math,
+                   double in,
+                   struct Dual *out);
+
+#endif
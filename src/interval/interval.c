@@ -0,0 +1,289 @@
+#include <math.h>
+#include <float.h>
+#include "../core/core.h"
+#include "interval.h"
+
+#define SLACK 1e-11
+#define PERIODIC 1e6
+#define HALF_PI 1.57079632679489661923
+#define TWO_PI 6.28318530717958647692
+
+static const struct Bounds whole = { -INFINITY, INFINITY };
+static const struct Bounds empty = { NAN, NAN };
+
+static struct Bounds outward(double lo, double hi) {
+    struct Bounds y = { nextafter(lo, -INFINITY), nextafter(hi, INFINITY) };
+    return y;
+}
+
+static struct Bounds widen(double lo, double hi) {
+    struct Bounds y;
+    y.lo = lo - fabs(lo) * SLACK - DBL_MIN;
+    y.hi = hi + fabs(hi) * SLACK + DBL_MIN;
+    return y;
+}
+
+static char contains(struct Bounds u, double offset, double period) {
+    double k = ceil((u.lo - offset) / period);
+    return offset + k * period <= u.hi;
+}
+
+static struct Bounds monotonic(double (*function)(double),
+                               struct Bounds u,
+                               char increasing) {
+    double a = function(u.lo), b = function(u.hi);
+    return increasing ? widen(a, b) : widen(b, a);
+}
+
+static struct Bounds periodic(double (*function)(double),
+                              struct Bounds u,
+                              double peak) {
+    double a, b;
+    if (fmax(fabs(u.lo), fabs(u.hi)) > PERIODIC || u.hi - u.lo >= TWO_PI) {
+        return (struct Bounds){ -1, 1 };
+    }
+    a = function(u.lo);
+    b = function(u.hi);
+    return widen(contains(u, peak + M_PI, TWO_PI) ? -1 : fmin(a, b),
+                 contains(u, peak, TWO_PI) ? 1 : fmax(a, b));
+}
+
+static struct Bounds unary(int function, struct Bounds u) {
+    double (*f)(double) = unary_lookup[function];
+    switch (function) {
+    case 0:
+    case 3:
+    case 4:
+    case 5:
+        if (u.hi < 0) {
+            return empty;
+        }
+        u.lo = fmax(u.lo, 0);
+        return monotonic(f, u, 1);
+    case 1:
+    case 2:
+    case 9:
+    case 11:
+        return monotonic(f, u, 1);
+    case 6:
+        return periodic(f, u, HALF_PI);
+    case 7:
+        return periodic(f, u, 0);
+    case 8:
+        if (fmax(fabs(u.lo), fabs(u.hi)) > PERIODIC || u.hi - u.lo >= M_PI ||
+            contains(u, HALF_PI, M_PI)) {
+            return whole;
+        }
+        return monotonic(f, u, 1);
+    default:
+        if (u.lo >= 0) {
+            return monotonic(f, u, 1);
+        }
+        if (u.hi <= 0) {
+            return monotonic(f, u, 0);
+        }
+        return widen(1, fmax(f(u.lo), f(u.hi)));
+    }
+}
+
+static struct Bounds corners(double (*f)(double, double),
+                             struct Bounds a,
+                             struct Bounds b) {
+    double p = f(a.lo, b.lo), q = f(a.lo, b.hi);
+    double r = f(a.hi, b.lo), s = f(a.hi, b.hi);
+    return (struct Bounds){ fmin(fmin(p, q), fmin(r, s)),
+                            fmax(fmax(p, q), fmax(r, s)) };
+}
+
+static double multiply(double a, double b) {
+    return a == 0 || b == 0 ? 0 : a * b;
+}
+
+static struct Bounds power(struct Bounds a, struct Bounds b) {
+    struct Bounds y;
+    double n = b.lo;
+    if (a.lo >= 0) {
+        y = corners(pow, a, b);
+        return widen(y.lo, y.hi);
+    }
+    if (b.lo != b.hi || n != rint(n) || fabs(n) > 1 << 30) {
+        return whole;
+    }
+    if (a.hi >= 0 && n < 0) {
+        return whole;
+    }
+    if (fmod(n, 2) != 0 || a.hi <= 0) {
+        y.lo = pow(a.lo, n);
+        y.hi = pow(a.hi, n);
+        return widen(fmin(y.lo, y.hi), fmax(y.lo, y.hi));
+    }
+    return widen(0, fmax(pow(a.lo, n), pow(a.hi, n)));
+}
+
+static struct Bounds square(struct Bounds u) {
+    double a = u.lo * u.lo, b = u.hi * u.hi;
+    if (u.lo <= 0 && u.hi >= 0) {
+        return outward(0, fmax(a, b));
+    }
+    return outward(fmin(a, b), fmax(a, b));
+}
+
+static struct Bounds binary(int op, struct Bounds a, struct Bounds b) {
+    struct Bounds y;
+    if (isnan(a.lo) || isnan(b.lo)) {
+        return empty;
+    }
+    switch (op) {
+    case OP_ADD:
+        return outward(a.lo + b.lo, a.hi + b.hi);
+    case OP_SUBTRACT:
+        return outward(a.lo - b.hi, a.hi - b.lo);
+    case OP_MULTIPLY:
+        y = corners(multiply, a, b);
+        return outward(y.lo, y.hi);
+    case OP_DIVIDE:
+        if (b.lo <= 0 && b.hi >= 0) {
+            return whole;
+        }
+        y = corners(binary_lookup[OP_DIVIDE - OP_BINARY], a, b);
+        return outward(y.lo, y.hi);
+    default:
+        return power(a, b);
+    }
+}
+
+static struct Bounds point(double x) {
+    return (struct Bounds){ x, x };
+}
+
+static struct Bounds unary_slope(int function,
+                                 struct Bounds u,
+                                 struct Bounds y) {
+    switch (function) {
+    case 0:
+        return binary(OP_DIVIDE, point(0.5), y);
+    case 1:
+        return y;
+    case 2:
+        return binary(OP_MULTIPLY, y, point(M_LN2));
+    case 3:
+        return binary(OP_DIVIDE, point(1), u);
+    case 4:
+        return binary(OP_DIVIDE, point(1 / M_LN10), u);
+    case 5:
+        return binary(OP_DIVIDE, point(1 / M_LN2), u);
+    case 6:
+        return unary(7, u);
+    case 7:
+        return binary(OP_SUBTRACT, point(0), unary(6, u));
+    case 8:
+        return binary(OP_ADD, point(1), square(y));
+    case 9:
+        return unary(10, u);
+    case 10:
+        return unary(9, u);
+    default:
+        return binary(OP_SUBTRACT, point(1), square(y));
+    }
+}
+
+static struct Bounds binary_slope(int op,
+                                  struct Bounds a,
+                                  struct Bounds da,
+                                  struct Bounds b,
+                                  struct Bounds db,
+                                  struct Bounds y) {
+    switch (op) {
+    case OP_ADD:
+    case OP_SUBTRACT:
+        return binary(op, da, db);
+    case OP_MULTIPLY:
+        return binary(OP_ADD, binary(OP_MULTIPLY, da, b),
+                      binary(OP_MULTIPLY, a, db));
+    case OP_DIVIDE:
+        return binary(OP_DIVIDE,
+                      binary(OP_SUBTRACT, da, binary(OP_MULTIPLY, y, db)),
+                      b);
+    default:
+        if (db.lo == 0 && db.hi == 0 && b.lo == b.hi) {
+            return binary(OP_MULTIPLY, binary(OP_MULTIPLY, point(b.lo), da),
+                          power(a, point(b.lo - 1)));
+        }
+        if (a.lo <= 0) {
+            return whole;
+        }
+        return binary(OP_MULTIPLY, y,
+                      binary(OP_ADD,
+                             binary(OP_MULTIPLY, db, unary(3, a)),
+                             binary(OP_MULTIPLY, b,
+                                    binary(OP_DIVIDE, da, a))));
+    }
+}
+
+static void run(const struct Program *program,
+                double lo,
+                double hi,
+                struct Bounds *values,
+                struct Bounds *slopes) {
+    const unsigned char *ii = program->code;
+    struct Bounds *u, *v, y, dy = empty;
+    values[0] = (struct Bounds){ lo, hi };
+    for (unsigned char r = 1; r < program->pinned; ++r) {
+        values[r] = point(program->pool[r]);
+    }
+    if (slopes) {
+        slopes[0] = point(1);
+        for (unsigned char r = 1; r < program->pinned; ++r) {
+            slopes[r] = point(0);
+        }
+    }
+    for (unsigned char i = 0; i < program->code_length; ++i, ++ii) {
+        u = values + program->a[i];
+        v = values + program->b[i];
+        if (*ii == OP_MULTIPLY && program->a[i] == program->b[i]) {
+            y = square(*u);
+            if (slopes) {
+                dy = binary(OP_MULTIPLY, binary(OP_MULTIPLY, point(2), *u),
+                            slopes[program->a[i]]);
+            }
+        } else if (*ii >= OP_BINARY) {
+            y = binary(*ii, *u, *v);
+            if (slopes) {
+                dy = binary_slope(*ii, *u, slopes[program->a[i]],
+                                  *v, slopes[program->b[i]], y);
+            }
+        } else if (isnan(u->lo)) {
+            y = empty;
+        } else {
+            y = unary(*ii - OP_UNARY, *u);
+            if (slopes && !isnan(y.lo)) {
+                dy = binary(OP_MULTIPLY, unary_slope(*ii - OP_UNARY, *u, y),
+                            slopes[program->a[i]]);
+            }
+        }
+        values[program->dst[i]] = y;
+        if (slopes) {
+            slopes[program->dst[i]] = isnan(y.lo) ? empty :
+                                      isfinite(y.lo) && isfinite(y.hi) ?
+                                      dy : whole;
+        }
+    }
+}
+
+void interval_evaluate(const struct Program *program,
+                       double lo,
+                       double hi,
+                       struct Bounds *out) {
+    struct Bounds values[REGISTERS];
+    run(program, lo, hi, values, NULL);
+    *out = values[program->result];
+}
+
+void interval_derivative(const struct Program *program,
+                         double lo,
+                         double hi,
+                         struct Bounds *out) {
+    struct Bounds values[REGISTERS], slopes[REGISTERS];
+    run(program, lo, hi, values, slopes);
+    *out = slopes[program->result];
+}
@@ -0,0 +1,20 @@
+#ifndef _INTERVAL_H_
+#define _INTERVAL_H_
+
+struct Program;
+
+struct Bounds {
+    double lo;
+    double hi;
+};
+
+void interval_evaluate(const struct Program *program,
+                       double lo,
+                       double hi,
+                       struct Bounds *out);
+void interval_derivative(const struct Program *program,
+                         double lo,
+                         double hi,
+                         struct Bounds *out);
+
+#endif
@@ -0,0 +1,182 @@
+#include <string.h>
+#include <math.h>
+#include "../core/core.h"
+#include "../vmath/vmath.h"
+#include "jit.h"
+
+#if defined(__x86_64__) && defined(__unix__)
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define MAX_OP_SIZE 40
+
+/*
+ * x86-64 SysV, scalar SSE2. Register r of the program lives in the
+ * 8 byte slot [rsp + 8 * r], except for the pinned constants, which
+ * are addressed RIP-relative in a pool placed after the code. xmm0
+ * always holds the destination of the previous instruction.
+ */
+
+struct Emitter {
+    unsigned char *iter;
+    const struct Program *program;
+    unsigned char *fixups[256];
+    unsigned char fixup_registers[256];
+    unsigned short fixup_count;
+};
+
+static void emit(struct Emitter *emitter, const void *bytes, size_t n) {
+    memcpy(emitter->iter, bytes, n);
+    emitter->iter += n;
+}
+
+static void emit_int(struct Emitter *emitter, int value) {
+    emit(emitter, &value, 4);
+}
+
+static void emit_sse(struct Emitter *emitter,
+                     unsigned char opcode,
+                     unsigned char xmm,
+                     unsigned char reg) {
+    unsigned char bytes[5] = { 0xf2, 0x0f, opcode, 0, 0x24 };
+    if (reg && reg < emitter->program->pinned) {
+        bytes[3] = 0x05 | (xmm << 3);
+        emit(emitter, bytes, 4);
+        emitter->fixups[emitter->fixup_count] = emitter->iter;
+        emitter->fixup_registers[emitter->fixup_count++] = reg;
+        emit_int(emitter, 0);
+    } else {
+        bytes[3] = 0x84 | (xmm << 3);
+        emit(emitter, bytes, 5);
+        emit_int(emitter, 8 * reg);
+    }
+}
+
+static void emit_call(struct Emitter *emitter, const void *target) {
+    static const unsigned char mov_rax[2] = { 0x48, 0xb8 };
+    static const unsigned char call_rax[2] = { 0xff, 0xd0 };
+    emit(emitter, mov_rax, 2);
+    emit(emitter, &target, 8);
+    emit(emitter, call_rax, 2);
+}
+
+int jit_compile(struct Jit *jit, const struct Program *program, int math) {
+    static const unsigned char sub_rsp[3] = { 0x48, 0x81, 0xec };
+    static const unsigned char add_rsp[3] = { 0x48, 0x81, 0xc4 };
+    static const unsigned char ret = 0xc3;
+    struct Emitter emitter;
+    unsigned char *pool;
+    unsigned char cached = 0;
+    int frame;
+    long page;
+    if (!jit) {
+        return 1;
+    }
+    jit_release(jit);
+    if (program->status) {
+        return 2;
+    }
+    page = sysconf(_SC_PAGESIZE);
+    jit->size = (size_t)program->code_length * MAX_OP_SIZE +
+                (size_t)program->pinned * 8 + 64;
+    jit->size = (jit->size + page - 1) / page * page;
+    jit->code = mmap(NULL, jit->size,
+                     PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS,
+                     -1, 0);
+    if (jit->code == MAP_FAILED) {
+        jit->code = NULL;
+        jit->size = 0;
+        return 3;
+    }
+    frame = 8 * program->registers;
+    if (!(frame % 16)) {
+        frame += 8;
+    }
+    emitter.iter = jit->code;
+    emitter.program = program;
+    emitter.fixup_count = 0;
+    emit(&emitter, sub_rsp, 3);
+    emit_int(&emitter, frame);
+    emit_sse(&emitter, 0x11, 0, 0);
+    for (unsigned char i = 0; i < program->code_length; ++i) {
+        unsigned char op = program->code[i];
+        if (program->a[i] != cached) {
+            emit_sse(&emitter, 0x10, 0, program->a[i]);
+        }
+        switch (op) {
+        case OP_ADD:
+            emit_sse(&emitter, 0x58, 0, program->b[i]);
+            break;
+        case OP_SUBTRACT:
+            emit_sse(&emitter, 0x5c, 0, program->b[i]);
+            break;
+        case OP_MULTIPLY:
+            emit_sse(&emitter, 0x59, 0, program->b[i]);
+            break;
+        case OP_DIVIDE:
+            emit_sse(&emitter, 0x5e, 0, program->b[i]);
+            break;
+        case OP_POW:
+            emit_sse(&emitter, 0x10, 1, program->b[i]);
+            emit_call(&emitter, vmath_scalar_pow[math]);
+            break;
+        default:
+            emit_call(&emitter, vmath_scalar[math][op - OP_UNARY]);
+            break;
+        }
+        emit_sse(&emitter, 0x11, 0, program->dst[i]);
+        cached = program->dst[i];
+    }
+    if (program->result != cached) {
+        emit_sse(&emitter, 0x10, 0, program->result);
+    }
+    emit(&emitter, add_rsp, 3);
+    emit_int(&emitter, frame);
+    emit(&emitter, &ret, 1);
+    pool = jit->code + ((emitter.iter - jit->code) + 7) / 8 * 8;
+    memcpy(pool, program->pool, program->pinned * sizeof(double));
+    for (unsigned short i = 0; i < emitter.fixup_count; ++i) {
+        int offset = (int)(pool + 8 * emitter.fixup_registers[i] -
+                           (emitter.fixups[i] + 4));
+        memcpy(emitter.fixups[i], &offset, 4);
+    }
+    if (mprotect(jit->code, jit->size, PROT_READ | PROT_EXEC)) {
+        jit_release(jit);
+        return 3;
+    }
+    jit->function = (double (*)(double))jit->code;
+    return 0;
+}
+
+void jit_release(struct Jit *jit) {
+    if (!jit) {
+        return;
+    }
+    if (jit->code) {
+        munmap(jit->code, jit->size);
+    }
+    jit->code = NULL;
+    jit->size = 0;
+    jit->function = NULL;
+}
+
+#else
+
+int jit_compile(struct Jit *jit, const struct Program *program, int math) {
+    (void)program;
+    (void)math;
+    if (jit) {
+        jit->function = NULL;
+    }
+    return 4;
+}
+
+void jit_release(struct Jit *jit) {
+    if (jit) {
+        jit->function = NULL;
+    }
+}
+
+#endif
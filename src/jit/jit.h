@@ -0,0 +1,17 @@
+#ifndef _JIT_H_
+#define _JIT_H_
+
+#include <stddef.h>
+
+struct Program;
+
+struct Jit {
+    unsigned char *code;
+    size_t size;
+    double (*function)(double);
+};
+
+int jit_compile(struct Jit *jit, const struct Program *program, int math);
+void jit_release(struct Jit *jit);
+
+#endif
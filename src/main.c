@@ -1,9 +1,107 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include "controller/controller.h"
+#include "cli/cli.h"
+#include "core/core.h"
+#include "pool/pool.h"
+#include "stats/stats.h"
 
-int main(void) {
+static void usage(const char *name) {
+    fprintf(stderr,
+            "Usage: %s [-i] [-c] [-n] [-j threads] [-t] [-r rule] [-m math]\n"
+            "       %*s [-P precision] [-M cache] [-p from,to] [-s]\n"
+            "       %*s [-f file]\n"
+            "       %*s [command [expression] args...]\n"
+            "Commands:\n"
+            "  eval                    evaluate every value read from stdin\n"
+            "  integrate from to [n]   integrate over [from, to]\n"
+            "  plot from to n          print n samples as x y pairs\n"
+            "  derive from to n        print n samples as x f f' f'' rows\n"
+            "  roots from to [n]       find every root, scanning n samples\n"
+            "  extrema from to [n]     find every local minimum and maximum\n"
+            "  bound from to           print a guaranteed range of f\n"
+            "  map input output        evaluate a file of raw little-endian\n"
+            "                          doubles into an output file\n",
+            name, (int)strlen(name), "", (int)strlen(name), "",
+            (int)strlen(name), "");
+}
+
+int main(int argc, char **argv) {
+    const char *path = NULL;
+    int opt;
+    int ret;
+    char dump = 0;
+    while ((opt = getopt(argc, argv, "+icnj:tr:m:P:M:p:sf:")) != -1) {
+        switch (opt) {
+        case 'i':
+            default_context.use_jit = 0;
+            break;
+        case 'c':
+            default_context.use_aot = 1;
+            break;
+        case 'n':
+            default_context.use_optimizer = 0;
+            break;
+        case 'j':
+            default_context.threads = atoi(optarg);
+            break;
+        case 't':
+            default_context.verify = 1;
+            break;
+        case 'r':
+            default_context.rule = cli_rule(optarg);
+            if (default_context.rule < 0) {
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'm':
+            default_context.math = cli_math(optarg);
+            if (default_context.math < 0) {
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'P':
+            default_context.precision = cli_precision(optarg);
+            if (default_context.precision < 0) {
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'M':
+            default_context.memo.limit = strtoul(optarg, NULL, 10) << 10;
+            break;
+        case 'p':
+            if (cli_tabulate(optarg)) {
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 's':
+            dump = 1;
+            break;
+        case 'f':
+            path = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (optind < argc) {
+        ret = cli_run(path, argc - optind, argv + optind);
+        pool_finalize();
+        if (dump) {
+            stats_dump(stderr);
+        }
+        return ret;
+    }
     controller_initialize();
     for (; controller_handle(););
     controller_finalize();
+    pool_finalize();
     return 0;
 }
@@ -0,0 +1,187 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../core/core.h"
+#include "memo.h"
+
+#define MEMO_MINIMUM 16
+
+static uint64_t hash_bytes(uint64_t hash, const void *data, size_t size) {
+    const unsigned char *iter = data;
+    for (size_t i = 0; i < size; ++i, ++iter) {
+        hash ^= *iter;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static uint64_t mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    return x ^ (x >> 33);
+}
+
+static size_t home(const struct Memo *memo, uint64_t program, uint64_t input) {
+    return mix(input ^ program) & (memo->capacity - 1);
+}
+
+static char expensive(const struct Program *program) {
+    for (unsigned char i = 0; i < program->code_length; ++i) {
+        if (program->code[i] < OP_BINARY || program->code[i] == OP_POW) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void memo_compile(struct Memo *memo, const struct Program *program, int math) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    size_t length = program->code_length;
+    memo_release(memo);
+    if (!expensive(program)) {
+        memo->program = 0;
+        return;
+    }
+    hash = hash_bytes(hash, &math, sizeof(int));
+    hash = hash_bytes(hash, program->code, length);
+    hash = hash_bytes(hash, program->dst, length);
+    hash = hash_bytes(hash, program->a, length);
+    hash = hash_bytes(hash, program->b, length);
+    hash = hash_bytes(hash, &program->result, 1);
+    hash = hash_bytes(hash,
+                      program->pool + 1,
+                      (program->pinned - 1) * sizeof(double));
+    memo->program = hash | 1;
+}
+
+static int allocate(struct Memo *memo) {
+    size_t capacity = MEMO_MINIMUM;
+    size_t entry = sizeof(struct MemoEntry) + 1;
+    if (memo->limit < capacity * entry) {
+        return 1;
+    }
+    for (; capacity * 2 * entry <= memo->limit; capacity *= 2);
+    memo->entries = calloc(capacity, sizeof(struct MemoEntry));
+    memo->referenced = calloc(capacity, 1);
+    if (!memo->entries || !memo->referenced) {
+        memo_release(memo);
+        return 1;
+    }
+    memo->capacity = capacity;
+    return 0;
+}
+
+static void remove_slot(struct Memo *memo, size_t i) {
+    size_t mask = memo->capacity - 1;
+    size_t j = i, k;
+    for (;;) {
+        j = (j + 1) & mask;
+        if (!memo->entries[j].program) {
+            break;
+        }
+        k = home(memo, memo->entries[j].program, memo->entries[j].input);
+        if (i <= j ? i < k && k <= j : i < k || k <= j) {
+            continue;
+        }
+        memo->entries[i] = memo->entries[j];
+        memo->referenced[i] = memo->referenced[j];
+        i = j;
+    }
+    memo->entries[i].program = 0;
+    memo->referenced[i] = 0;
+    --memo->size;
+}
+
+/*
+ * Second chance over the probe run the new input lands in, so holes open
+ * where inserts go instead of piling up behind a global hand.
+ */
+static void evict(struct Memo *memo, size_t slot) {
+    size_t mask = memo->capacity - 1;
+    size_t first;
+    for (; !memo->entries[slot].program; slot = (slot + 1) & mask);
+    for (first = slot; memo->entries[slot].program;
+         slot = (slot + 1) & mask) {
+        if (!memo->referenced[slot]) {
+            first = slot;
+            break;
+        }
+        memo->referenced[slot] = 0;
+    }
+    remove_slot(memo, first);
+    ++memo->evictions;
+}
+
+int memo_lookup(struct Memo *memo, double in, double *out) {
+    uint64_t input;
+    size_t mask = memo->capacity - 1;
+    size_t slot;
+    if (!memo->program || !memo->limit) {
+        return 0;
+    }
+    if (!memo->entries) {
+        ++memo->misses;
+        return 0;
+    }
+    memcpy(&input, &in, sizeof(double));
+    for (slot = home(memo, memo->program, input);
+         memo->entries[slot].program;
+         slot = (slot + 1) & mask) {
+        if (memo->entries[slot].program == memo->program &&
+            memo->entries[slot].input == input) {
+            memo->referenced[slot] = 1;
+            *out = memo->entries[slot].value;
+            ++memo->hits;
+            return 1;
+        }
+    }
+    ++memo->misses;
+    return 0;
+}
+
+void memo_insert(struct Memo *memo, double in, double out) {
+    uint64_t input;
+    size_t mask;
+    size_t slot;
+    if (!memo->program || !memo->limit) {
+        return;
+    }
+    if (!memo->entries && allocate(memo)) {
+        return;
+    }
+    memcpy(&input, &in, sizeof(double));
+    if (memo->size >= memo->capacity / 4 * 3) {
+        evict(memo, home(memo, memo->program, input));
+    }
+    mask = memo->capacity - 1;
+    for (slot = home(memo, memo->program, input);
+         memo->entries[slot].program;
+         slot = (slot + 1) & mask) {
+        if (memo->entries[slot].program == memo->program &&
+            memo->entries[slot].input == input) {
+            memo->entries[slot].value = out;
+            return;
+        }
+    }
+    memo->entries[slot].program = memo->program;
+    memo->entries[slot].input = input;
+    memo->entries[slot].value = out;
+    memo->referenced[slot] = 0;
+    ++memo->size;
+}
+
+void memo_release(struct Memo *memo) {
+    free(memo->entries);
+    free(memo->referenced);
+    memo->entries = NULL;
+    memo->referenced = NULL;
+    memo->capacity = 0;
+    memo->size = 0;
+}
+
+void memo_reset(struct Memo *memo) {
+    memo->hits = 0;
+    memo->misses = 0;
+    memo->evictions = 0;
+}
@@ -0,0 +1,35 @@
+#ifndef _MEMO_H_
+#define _MEMO_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MEMO_LIMIT (1UL << 20)
+
+struct Program;
+
+struct MemoEntry {
+    uint64_t program;
+    uint64_t input;
+    double value;
+};
+
+struct Memo {
+    struct MemoEntry *entries;
+    unsigned char *referenced;
+    size_t capacity;
+    size_t size;
+    size_t limit;
+    uint64_t program;
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long evictions;
+};
+
+void memo_compile(struct Memo *memo, const struct Program *program, int math);
+int memo_lookup(struct Memo *memo, double in, double *out);
+void memo_insert(struct Memo *memo, double in, double out);
+void memo_release(struct Memo *memo);
+void memo_reset(struct Memo *memo);
+
+#endif
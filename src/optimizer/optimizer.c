@@ -0,0 +1,244 @@
+#include <stdlib.h>
+#include <math.h>
+#include "optimizer.h"
+
+#define POW_INT 0xff
+#define MAX_POW_INT 32
+
+struct Node {
+    unsigned char op;
+    unsigned char a, b;
+    double number;
+    int exponent;
+};
+
+struct Tree {
+    struct Node nodes[256];
+    unsigned short size;
+};
+
+static unsigned char add_node(struct Tree *tree,
+                              unsigned char op,
+                              unsigned char a,
+                              unsigned char b,
+                              double number) {
+    struct Node *node = tree->nodes + tree->size;
+    node->op = op;
+    node->a = a;
+    node->b = b;
+    node->number = number;
+    node->exponent = 0;
+    return tree->size++;
+}
+
+static char is_number(const struct Tree *tree, unsigned char node, double value) {
+    return tree->nodes[node].op == OP_NUMBER &&
+           tree->nodes[node].number == value;
+}
+
+static unsigned char simplify(struct Tree *tree, unsigned char index) {
+    struct Node *node = tree->nodes + index;
+    unsigned char a, b;
+    double exponent;
+    if (node->op == OP_INPUT || node->op == OP_NUMBER) {
+        return index;
+    }
+    a = simplify(tree, node->a);
+    node->a = a;
+    if (node->op < OP_BINARY) {
+        if (tree->nodes[a].op == OP_NUMBER) {
+            node->number = unary_lookup[node->op - OP_UNARY](
+                tree->nodes[a].number
+            );
+            node->op = OP_NUMBER;
+        }
+        return index;
+    }
+    b = simplify(tree, node->b);
+    node->b = b;
+    if (tree->nodes[a].op == OP_NUMBER && tree->nodes[b].op == OP_NUMBER) {
+        node->number = binary_lookup[node->op - OP_BINARY](
+            tree->nodes[a].number,
+            tree->nodes[b].number
+        );
+        node->op = OP_NUMBER;
+        return index;
+    }
+    switch (node->op) {
+    case OP_ADD:
+        if (is_number(tree, a, 0)) {
+            return b;
+        }
+        if (is_number(tree, b, 0)) {
+            return a;
+        }
+        break;
+    case OP_SUBTRACT:
+        if (is_number(tree, b, 0)) {
+            return a;
+        }
+        break;
+    case OP_MULTIPLY:
+        if (is_number(tree, a, 1)) {
+            return b;
+        }
+        if (is_number(tree, b, 1)) {
+            return a;
+        }
+        break;
+    case OP_DIVIDE:
+        if (is_number(tree, b, 1)) {
+            return a;
+        }
+        break;
+    case OP_POW:
+        if (tree->nodes[b].op != OP_NUMBER) {
+            break;
+        }
+        exponent = tree->nodes[b].number;
+        if (exponent == 0) {
+            node->op = OP_NUMBER;
+            node->number = 1;
+            return index;
+        }
+        if (exponent == 1) {
+            return a;
+        }
+        if (exponent == floor(exponent) && fabs(exponent) <= MAX_POW_INT) {
+            node->op = POW_INT;
+            node->exponent = (int)exponent;
+        }
+        break;
+    }
+    return index;
+}
+
+struct Emitter {
+    struct Program *program;
+    unsigned char length;
+    unsigned char constants;
+    unsigned char depth;
+    char overflow;
+};
+
+static void emit_op(struct Emitter *emitter, unsigned char op) {
+    if (emitter->length == 100) {
+        emitter->overflow = 1;
+        return;
+    }
+    emitter->program->ops[emitter->length++] = op;
+    switch (op) {
+    case OP_INPUT:
+    case OP_NUMBER:
+    case OP_DUP:
+        if (++emitter->depth > emitter->program->depth) {
+            emitter->program->depth = emitter->depth;
+        }
+        break;
+    default:
+        if (op >= OP_BINARY) {
+            --emitter->depth;
+        }
+        break;
+    }
+}
+
+static void emit_number(struct Emitter *emitter, double number) {
+    emit_op(emitter, OP_NUMBER);
+    if (!emitter->overflow) {
+        emitter->program->constants[emitter->constants++] = number;
+    }
+}
+
+static void emit_power(struct Emitter *emitter, unsigned int exponent) {
+    if (exponent == 1) {
+        return;
+    }
+    if (exponent % 2) {
+        emit_op(emitter, OP_DUP);
+        emit_power(emitter, exponent - 1);
+    } else {
+        emit_power(emitter, exponent / 2);
+        emit_op(emitter, OP_DUP);
+    }
+    emit_op(emitter, OP_MULTIPLY);
+}
+
+static void emit_node(struct Emitter *emitter,
+                      const struct Tree *tree,
+                      unsigned char index) {
+    const struct Node *node = tree->nodes + index;
+    switch (node->op) {
+    case OP_INPUT:
+        emit_op(emitter, OP_INPUT);
+        break;
+    case OP_NUMBER:
+        emit_number(emitter, node->number);
+        break;
+    case POW_INT:
+        if (node->exponent < 0) {
+            emit_number(emitter, 1);
+        }
+        emit_node(emitter, tree, node->a);
+        emit_power(emitter, abs(node->exponent));
+        if (node->exponent < 0) {
+            emit_op(emitter, OP_DIVIDE);
+        }
+        break;
+    default:
+        emit_node(emitter, tree, node->a);
+        if (node->op >= OP_BINARY) {
+            emit_node(emitter, tree, node->b);
+        }
+        emit_op(emitter, node->op);
+        break;
+    }
+}
+
+int optimizer_run(struct Program *program) {
+    struct Tree tree;
+    unsigned char stack[100];
+    unsigned char *sp = stack;
+    unsigned char root;
+    const double *constant = program->constants;
+    struct Program optimized;
+    struct Emitter emitter = { &optimized, 0, 0, 0, 0 };
+    if (program->status) {
+        return 0;
+    }
+    tree.size = 0;
+    const unsigned char *ops_end = program->ops + program->length;
+    for (const unsigned char *ii = program->ops; ii < ops_end; ++ii) {
+        switch (*ii) {
+        case OP_INPUT:
+            *(sp++) = add_node(&tree, OP_INPUT, 0, 0, 0);
+            break;
+        case OP_NUMBER:
+            *(sp++) = add_node(&tree, OP_NUMBER, 0, 0, *(constant++));
+            break;
+        case OP_DUP:
+            sp[0] = sp[-1];
+            ++sp;
+            break;
+        default:
+            if (*ii >= OP_BINARY) {
+                sp[-2] = add_node(&tree, *ii, sp[-2], sp[-1], 0);
+                --sp;
+            } else {
+                sp[-1] = add_node(&tree, *ii, sp[-1], 0, 0);
+            }
+            break;
+        }
+    }
+    root = simplify(&tree, sp[-1]);
+    optimized.depth = 0;
+    optimized.status = 0;
+    emit_node(&emitter, &tree, root);
+    if (emitter.overflow) {
+        return 0;
+    }
+    optimized.length = emitter.length;
+    optimized.removed = (int)program->length - emitter.length;
+    *program = optimized;
+    return program->removed;
+}
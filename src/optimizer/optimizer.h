@@ -0,0 +1,8 @@
+#ifndef _OPTIMIZER_H_
+#define _OPTIMIZER_H_
+
+#include "../core/core.h"
+
+int optimizer_run(struct Program *program);
+
+#endif
@@ -0,0 +1,200 @@
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include "../core/core.h"
+#include "polynomial.h"
+
+#pragma GCC optimize("fp-contract=off")
+
+#define LANES 64
+
+struct Term {
+    double c[POLYNOMIAL_DEGREE + 1];
+    int degree;
+};
+
+static void trim(struct Term *term) {
+    for (; term->degree > 0 && term->c[term->degree] == 0; --term->degree);
+}
+
+static char multiply(struct Term *a, const struct Term *b) {
+    double product[POLYNOMIAL_DEGREE + 1];
+    if (a->degree + b->degree > POLYNOMIAL_DEGREE) {
+        return 1;
+    }
+    memset(product, 0, (a->degree + b->degree + 1) * sizeof(double));
+    for (int i = 0; i <= a->degree; ++i) {
+        for (int j = 0; j <= b->degree; ++j) {
+            product[i + j] += a->c[i] * b->c[j];
+        }
+    }
+    a->degree += b->degree;
+    memcpy(a->c, product, (a->degree + 1) * sizeof(double));
+    trim(a);
+    return 0;
+}
+
+static char power(struct Term *a, const struct Term *b) {
+    struct Term base = *a;
+    double exponent = b->c[0];
+    if (b->degree) {
+        return 1;
+    }
+    if (!a->degree) {
+        a->c[0] = pow(a->c[0], exponent);
+        return 0;
+    }
+    if (exponent != floor(exponent) || exponent < 0 ||
+        exponent * a->degree > POLYNOMIAL_DEGREE) {
+        return 1;
+    }
+    a->c[0] = 1;
+    a->degree = 0;
+    for (int i = 0; i < exponent; ++i) {
+        multiply(a, &base);
+    }
+    return 0;
+}
+
+static char combine(unsigned char op, struct Term *a, const struct Term *b) {
+    switch (op) {
+    case OP_ADD:
+    case OP_SUBTRACT:
+        for (int i = a->degree + 1; i <= b->degree; ++i) {
+            a->c[i] = 0;
+        }
+        if (b->degree > a->degree) {
+            a->degree = b->degree;
+        }
+        for (int i = 0; i <= b->degree; ++i) {
+            a->c[i] += op == OP_ADD ? b->c[i] : -b->c[i];
+        }
+        trim(a);
+        return 0;
+    case OP_MULTIPLY:
+        return multiply(a, b);
+    case OP_DIVIDE:
+        if (b->degree || b->c[0] == 0) {
+            return 1;
+        }
+        for (int i = 0; i <= a->degree; ++i) {
+            a->c[i] /= b->c[0];
+        }
+        return 0;
+    default:
+        return power(a, b);
+    }
+}
+
+int polynomial_compile(struct Polynomial *polynomial,
+                       const struct Program *program) {
+    struct Term stack[100];
+    struct Term *sp = stack;
+    const double *constant = program->constants;
+    const unsigned char *ops_end = program->ops + program->length;
+    polynomial->degree = -1;
+    for (const unsigned char *ii = program->ops; ii < ops_end; ++ii) {
+        switch (*ii) {
+        case OP_INPUT:
+            sp->c[0] = 0;
+            sp->c[1] = 1;
+            sp->degree = 1;
+            ++sp;
+            break;
+        case OP_NUMBER:
+            sp->c[0] = *(constant++);
+            sp->degree = 0;
+            ++sp;
+            break;
+        case OP_DUP:
+            sp[0] = sp[-1];
+            ++sp;
+            break;
+        default:
+            if (*ii >= OP_BINARY) {
+                if (combine(*ii, sp - 2, sp - 1)) {
+                    return 1;
+                }
+                --sp;
+            } else if (sp[-1].degree) {
+                return 1;
+            } else {
+                sp[-1].c[0] = unary_lookup[*ii - OP_UNARY](sp[-1].c[0]);
+            }
+            break;
+        }
+    }
+    for (int i = 0; i <= stack->degree; ++i) {
+        if (!isfinite(stack->c[i])) {
+            return 1;
+        }
+    }
+    polynomial->degree = stack->degree;
+    memcpy(polynomial->coefficients, stack->c,
+           (stack->degree + 1) * sizeof(double));
+    polynomial->integral[0] = 0;
+    for (int i = 0; i <= stack->degree; ++i) {
+        polynomial->integral[i + 1] = stack->c[i] / (i + 1);
+    }
+    return 0;
+}
+
+static double horner(const double *c, int degree, double x, double *bound) {
+    double value = c[degree];
+    double magnitude = fabs(c[degree]);
+    for (int i = degree - 1; i >= 0; --i) {
+        value = value * x + c[i];
+        magnitude = magnitude * fabs(x) + fabs(c[i]);
+    }
+    *bound = magnitude;
+    return value;
+}
+
+double polynomial_evaluate(const struct Polynomial *polynomial,
+                           double x,
+                           double *bound) {
+    return horner(polynomial->coefficients, polynomial->degree, x, bound);
+}
+
+__attribute__((target_clones("avx512f", "avx2", "default")))
+void polynomial_evaluate_batch(const struct Polynomial *polynomial,
+                               const double *in,
+                               double *out,
+                               double *bounds,
+                               size_t n) {
+    const double *c = polynomial->coefficients;
+    int degree = polynomial->degree;
+    double x[LANES], v[LANES], m[LANES];
+    size_t len;
+    for (size_t base = 0; base < n; base += len) {
+        len = n - base < LANES ? n - base : LANES;
+        for (size_t i = 0; i < LANES; ++i) {
+            x[i] = i < len ? in[base + i] : 0;
+            v[i] = c[degree];
+            m[i] = fabs(c[degree]);
+        }
+        for (int j = degree - 1; j >= 0; --j) {
+            for (size_t i = 0; i < LANES; ++i) {
+                v[i] = v[i] * x[i] + c[j];
+                m[i] = m[i] * fabs(x[i]) + fabs(c[j]);
+            }
+        }
+        memcpy(out + base, v, len * sizeof(double));
+        memcpy(bounds + base, m, len * sizeof(double));
+    }
+}
+
+char polynomial_stable(double value, double bound) {
+    return bound <= POLYNOMIAL_CONDITION * fabs(value);
+}
+
+double polynomial_integral(const struct Polynomial *polynomial,
+                           double from,
+                           double to,
+                           double *error) {
+    double lower, upper, low, high;
+    low = horner(polynomial->integral, polynomial->degree + 1, from, &lower);
+    high = horner(polynomial->integral, polynomial->degree + 1, to, &upper);
+    *error = 2 * (polynomial->degree + 3) * DBL_EPSILON * (lower + upper);
+    return high - low;
+}
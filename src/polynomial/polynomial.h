@@ -0,0 +1,33 @@
+#ifndef _POLYNOMIAL_H_
+#define _POLYNOMIAL_H_
+
+#include <stddef.h>
+
+#define POLYNOMIAL_DEGREE 32
+#define POLYNOMIAL_CONDITION 1024
+
+struct Program;
+
+struct Polynomial {
+    double coefficients[POLYNOMIAL_DEGREE + 1];
+    double integral[POLYNOMIAL_DEGREE + 2];
+    int degree;
+};
+
+int polynomial_compile(struct Polynomial *polynomial,
+                       const struct Program *program);
+double polynomial_evaluate(const struct Polynomial *polynomial,
+                           double x,
+                           double *bound);
+void polynomial_evaluate_batch(const struct Polynomial *polynomial,
+                               const double *in,
+                               double *out,
+                               double *bounds,
+                               size_t n);
+char polynomial_stable(double value, double bound);
+double polynomial_integral(const struct Polynomial *polynomial,
+                           double from,
+                           double to,
+                           double *error);
+
+#endif
@@ -0,0 +1,145 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "pool.h"
+
+static struct {
+    pthread_t *workers;
+    unsigned int size;
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    pthread_mutex_t run_lock;
+    unsigned long generation;
+    unsigned int busy;
+    char stop;
+    Task task;
+    void *arg;
+    unsigned long count;
+    atomic_ulong next;
+    atomic_uint started;
+} pool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .start = PTHREAD_COND_INITIALIZER,
+    .done = PTHREAD_COND_INITIALIZER,
+    .run_lock = PTHREAD_MUTEX_INITIALIZER
+};
+
+static __thread unsigned int worker;
+
+static void drain(Task task, void *arg, unsigned long count) {
+    unsigned long index;
+    while ((index = atomic_fetch_add(&pool.next, 1)) < count) {
+        task(arg, index);
+    }
+}
+
+static void *work(void *generation) {
+    unsigned long seen = (uintptr_t)generation;
+    Task task;
+    void *arg;
+    unsigned long count;
+    worker = atomic_fetch_add(&pool.started, 1) + 1;
+    pthread_mutex_lock(&pool.lock);
+    for (;;) {
+        while (!pool.stop && pool.generation == seen) {
+            pthread_cond_wait(&pool.start, &pool.lock);
+        }
+        if (pool.stop) {
+            break;
+        }
+        seen = pool.generation;
+        task = pool.task;
+        arg = pool.arg;
+        count = pool.count;
+        pthread_mutex_unlock(&pool.lock);
+        drain(task, arg, count);
+        pthread_mutex_lock(&pool.lock);
+        if (!--pool.busy) {
+            pthread_cond_signal(&pool.done);
+        }
+    }
+    pthread_mutex_unlock(&pool.lock);
+    return NULL;
+}
+
+int pool_initialize(unsigned int threads) {
+    long online;
+    if (!threads) {
+        online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? online : 1;
+    }
+    if (threads == pool.size + 1) {
+        return 0;
+    }
+    pool_finalize();
+    pthread_mutex_lock(&pool.run_lock);
+    if (threads > 1) {
+        pool.workers = malloc((threads - 1) * sizeof(pthread_t));
+        if (!pool.workers) {
+            pthread_mutex_unlock(&pool.run_lock);
+            return 1;
+        }
+    }
+    pool.stop = 0;
+    for (; pool.size < threads - 1; ++pool.size) {
+        if (pthread_create(pool.workers + pool.size,
+                           NULL,
+                           work,
+                           (void *)(uintptr_t)pool.generation)) {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&pool.run_lock);
+    return pool.size != threads - 1;
+}
+
+void pool_finalize(void) {
+    pthread_mutex_lock(&pool.run_lock);
+    pthread_mutex_lock(&pool.lock);
+    pool.stop = 1;
+    pthread_cond_broadcast(&pool.start);
+    pthread_mutex_unlock(&pool.lock);
+    for (unsigned int i = 0; i < pool.size; ++i) {
+        pthread_join(pool.workers[i], NULL);
+    }
+    free(pool.workers);
+    pool.workers = NULL;
+    pool.size = 0;
+    atomic_store(&pool.started, 0);
+    pthread_mutex_unlock(&pool.run_lock);
+}
+
+unsigned int pool_threads(void) {
+    return pool.size + 1;
+}
+
+unsigned int pool_worker(void) {
+    return worker;
+}
+
+void pool_run(Task task, void *arg, unsigned long count) {
+    pthread_mutex_lock(&pool.run_lock);
+    atomic_store(&pool.next, 0);
+    if (pool.size && count > 1) {
+        pthread_mutex_lock(&pool.lock);
+        pool.task = task;
+        pool.arg = arg;
+        pool.count = count;
+        pool.busy = pool.size;
+        ++pool.generation;
+        pthread_cond_broadcast(&pool.start);
+        pthread_mutex_unlock(&pool.lock);
+        drain(task, arg, count);
+        pthread_mutex_lock(&pool.lock);
+        while (pool.busy) {
+            pthread_cond_wait(&pool.done, &pool.lock);
+        }
+        pthread_mutex_unlock(&pool.lock);
+    } else {
+        drain(task, arg, count);
+    }
+    pthread_mutex_unlock(&pool.run_lock);
+}
@@ -0,0 +1,12 @@
+#ifndef _POOL_H_
+#define _POOL_H_
+
+typedef void (*Task)(void *arg, unsigned long index);
+
+int pool_initialize(unsigned int threads);
+void pool_finalize(void);
+unsigned int pool_threads(void);
+unsigned int pool_worker(void);
+void pool_run(Task task, void *arg, unsigned long count);
+
+#endif
@@ -0,0 +1,93 @@
+/*
+ * Columnar evaluator, included once per precision by precision.c with
+ * PRECISION_NAME and PRECISION_TYPE defined and the element operations
+ * NAME(load), NAME(store), NAME(add), NAME(subtract), NAME(multiply) and
+ * NAME(divide) and the column operations NAME(unary) and NAME(pow) in scope.
+ * With PRECISION_TIERED defined the evaluator and the column operations also
+ * take the math tier.
+ * Columns are processed in whole groups of LANES, copied out first since the
+ * destination may be an operand, so the arithmetic loops have a fixed trip
+ * count and no aliasing and vectorize.
+ */
+
+#define T PRECISION_TYPE
+#ifdef PRECISION_TIERED
+#define TIER math,
+#define TIER_PARAMETER int math,
+#else
+#define TIER
+#define TIER_PARAMETER
+#endif
+#define COLUMN(op) \
+    for (size_t j = 0; j < width; j += LANES) { \
+        memcpy(xs, x + j, sizeof(xs)); \
+        memcpy(ys, y + j, sizeof(ys)); \
+        for (size_t k = 0; k < LANES; ++k) { \
+            d[j + k] = NAME(op)(xs[k], ys[k]); \
+        } \
+    }
+
+static void NAME(evaluate)(const struct Program *program,
+                           TIER_PARAMETER
+                           T (*columns)[BLOCK],
+                           const double *in,
+                           double *out,
+                           size_t n) {
+    T *d, *x, *y;
+    T xs[LANES], ys[LANES];
+    size_t len, width;
+    for (unsigned char r = 1; r < program->pinned; ++r) {
+        for (size_t j = 0; j < BLOCK; ++j) {
+            columns[r][j] = NAME(load)(program->pool[r]);
+        }
+    }
+    const unsigned char *code_end = program->code + program->code_length;
+    for (size_t base = 0; base < n; base += len, in += len, out += len) {
+        len = n - base < BLOCK ? n - base : BLOCK;
+        width = (len + LANES - 1) / LANES * LANES;
+        for (size_t j = 0; j < width; ++j) {
+            columns[0][j] = NAME(load)(j < len ? in[j] : 0);
+        }
+        const unsigned char *dst = program->dst;
+        const unsigned char *a = program->a;
+        const unsigned char *b = program->b;
+        for (const unsigned char *ii = program->code;
+             ii < code_end;
+             ++ii, ++dst, ++a, ++b) {
+            d = columns[*dst];
+            x = columns[*a];
+            y = columns[*b];
+            STATS_BEGIN(begin);
+            switch (*ii) {
+            case OP_ADD:
+                COLUMN(add);
+                break;
+            case OP_SUBTRACT:
+                COLUMN(subtract);
+                break;
+            case OP_MULTIPLY:
+                COLUMN(multiply);
+                break;
+            case OP_DIVIDE:
+                COLUMN(divide);
+                break;
+            case OP_POW:
+                NAME(pow)(TIER x, y, d, width);
+                break;
+            default:
+                NAME(unary)(TIER *ii - OP_UNARY, x, d, width);
+                break;
+            }
+            STATS_OP(*ii, len, begin);
+            STATS_LOADS(*ii, *a, *b, program->pinned, len);
+        }
+        for (size_t j = 0; j < len; ++j) {
+            out[j] = NAME(store)(columns[program->result][j]);
+        }
+    }
+}
+
+#undef TIER_PARAMETER
+#undef TIER
+#undef COLUMN
+#undef T
@@ -0,0 +1,335 @@
+#include <string.h>
+#include <math.h>
+#include "../stats/stats.h"
+#include "../vmath/vmath.h"
+#include "precision.h"
+
+#pragma GCC optimize("fp-contract=off")
+
+#define LANES 8
+#define CAT_(a, b) a##_##b
+#define CAT(a, b) CAT_(a, b)
+#define NAME(name) CAT(name, PRECISION_NAME)
+#define INLINE static inline __attribute__((always_inline))
+
+const char *precision_names[3] = {
+    "double",
+    "float",
+    "double-double"
+};
+
+struct DoubleDouble {
+    double hi;
+    double lo;
+};
+
+#define PRECISION_NAME double
+#define PRECISION_TYPE double
+#define PRECISION_TIERED
+
+INLINE double NAME(load)(double x) {
+    return x;
+}
+
+INLINE double NAME(store)(double x) {
+    return x;
+}
+
+INLINE double NAME(add)(double a, double b) {
+    return a + b;
+}
+
+INLINE double NAME(subtract)(double a, double b) {
+    return a - b;
+}
+
+INLINE double NAME(multiply)(double a, double b) {
+    return a * b;
+}
+
+INLINE double NAME(divide)(double a, double b) {
+    return a / b;
+}
+
+INLINE void NAME(unary)(int math,
+                        int k,
+                        const double *x,
+                        double *y,
+                        size_t n) {
+    vmath_unary[math][k](x, y, n);
+}
+
+INLINE void NAME(pow)(int math,
+                      const double *x,
+                      const double *y,
+                      double *z,
+                      size_t n) {
+    vmath_pow[math](x, y, z, n);
+}
+
+#include "evaluator.h"
+#undef PRECISION_TIERED
+#undef PRECISION_TYPE
+#undef PRECISION_NAME
+
+#define PRECISION_NAME float
+#define PRECISION_TYPE float
+
+static float (*const NAME(functions)[12])(float) = {
+    sqrtf,
+    expf,
+    exp2f,
+    logf,
+    log10f,
+    log2f,
+    sinf,
+    cosf,
+    tanf,
+    sinhf,
+    coshf,
+    tanhf
+};
+
+INLINE float NAME(load)(double x) {
+    return x;
+}
+
+INLINE double NAME(store)(float x) {
+    return x;
+}
+
+INLINE float NAME(add)(float a, float b) {
+    return a + b;
+}
+
+INLINE float NAME(subtract)(float a, float b) {
+    return a - b;
+}
+
+INLINE float NAME(multiply)(float a, float b) {
+    return a * b;
+}
+
+INLINE float NAME(divide)(float a, float b) {
+    return a / b;
+}
+
+INLINE void NAME(unary)(int k, const float *x, float *y, size_t n) {
+    if (!k) {
+        for (size_t i = 0; i < n; ++i) {
+            y[i] = sqrtf(x[i]);
+        }
+        return;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        y[i] = NAME(functions)[k](x[i]);
+    }
+}
+
+INLINE void NAME(pow)(const float *x,
+                      const float *y,
+                      float *z,
+                      size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        z[i] = powf(x[i], y[i]);
+    }
+}
+
+#include "evaluator.h"
+#undef PRECISION_TYPE
+#undef PRECISION_NAME
+
+/*
+ * Double-double arithmetic keeps an unevaluated sum hi + lo with |lo| at
+ * most half an ulp of hi. Sums use two_sum, products an exact fma residual.
+ * Unary functions and non-integer powers take f(hi) from libm and add the
+ * first-order term f'(hi) * lo, so they carry the perturbation of the low
+ * part but are only as accurate as double themselves.
+ */
+#define PRECISION_NAME double_double
+#define PRECISION_TYPE struct DoubleDouble
+
+INLINE struct DoubleDouble quick_sum(double a, double b) {
+    double s = a + b;
+    if (!isfinite(s)) {
+        return (struct DoubleDouble){ s, 0 };
+    }
+    return (struct DoubleDouble){ s, b - (s - a) };
+}
+
+INLINE struct DoubleDouble two_sum(double a, double b) {
+    double s = a + b;
+    double v = s - a;
+    return (struct DoubleDouble){ s, (a - (s - v)) + (b - v) };
+}
+
+INLINE struct DoubleDouble NAME(load)(double x) {
+    return (struct DoubleDouble){ x, 0 };
+}
+
+INLINE double NAME(store)(struct DoubleDouble x) {
+    return x.lo == 0 ? x.hi : x.hi + x.lo;
+}
+
+INLINE struct DoubleDouble NAME(add)(struct DoubleDouble a,
+                                     struct DoubleDouble b) {
+    struct DoubleDouble s = two_sum(a.hi, b.hi);
+    struct DoubleDouble t;
+    if (!isfinite(s.hi)) {
+        return (struct DoubleDouble){ s.hi, 0 };
+    }
+    t = two_sum(a.lo, b.lo);
+    s = quick_sum(s.hi, s.lo + t.hi);
+    return quick_sum(s.hi, s.lo + t.lo);
+}
+
+INLINE struct DoubleDouble NAME(subtract)(struct DoubleDouble a,
+                                          struct DoubleDouble b) {
+    return NAME(add)(a, (struct DoubleDouble){ -b.hi, -b.lo });
+}
+
+INLINE struct DoubleDouble NAME(multiply)(struct DoubleDouble a,
+                                          struct DoubleDouble b) {
+    double p = a.hi * b.hi;
+    if (!isfinite(p) || p == 0) {
+        return (struct DoubleDouble){ p, 0 };
+    }
+    return quick_sum(p, fma(a.hi, b.hi, -p) + (a.hi * b.lo + a.lo * b.hi));
+}
+
+INLINE struct DoubleDouble NAME(divide)(struct DoubleDouble a,
+                                        struct DoubleDouble b) {
+    double q1 = a.hi / b.hi, q2, q3;
+    struct DoubleDouble r;
+    if (!isfinite(q1) || !isfinite(b.hi) || b.hi == 0) {
+        return (struct DoubleDouble){ q1, 0 };
+    }
+    r = NAME(subtract)(a, NAME(multiply)(b, NAME(load)(q1)));
+    if (!isfinite(r.hi)) {
+        return (struct DoubleDouble){ q1, 0 };
+    }
+    q2 = r.hi / b.hi;
+    r = NAME(subtract)(r, NAME(multiply)(b, NAME(load)(q2)));
+    q3 = r.hi / b.hi;
+    return NAME(add)(quick_sum(q1, q2), NAME(load)(q3));
+}
+
+static struct DoubleDouble NAME(function)(int k, struct DoubleDouble a) {
+    double f, slope;
+    if (k == 0) {
+        if (!(a.hi > 0) || !isfinite(a.hi)) {
+            return NAME(load)(sqrt(a.hi));
+        }
+        f = sqrt(a.hi);
+        a = NAME(subtract)(a, NAME(multiply)(NAME(load)(f), NAME(load)(f)));
+        return quick_sum(f, a.hi / (2 * f));
+    }
+    f = unary_lookup[k](a.hi);
+    if (!isfinite(f) || a.lo == 0) {
+        return NAME(load)(f);
+    }
+    switch (k) {
+    case 1:
+        slope = f;
+        break;
+    case 2:
+        slope = f * M_LN2;
+        break;
+    case 3:
+        slope = 1 / a.hi;
+        break;
+    case 4:
+        slope = 1 / (a.hi * M_LN10);
+        break;
+    case 5:
+        slope = 1 / (a.hi * M_LN2);
+        break;
+    case 6:
+        slope = cos(a.hi);
+        break;
+    case 7:
+        slope = -sin(a.hi);
+        break;
+    case 8:
+        slope = 1 + f * f;
+        break;
+    case 9:
+        slope = cosh(a.hi);
+        break;
+    case 10:
+        slope = sinh(a.hi);
+        break;
+    default:
+        slope = 1 - f * f;
+        break;
+    }
+    slope *= a.lo;
+    return isfinite(slope) ? quick_sum(f, slope) : NAME(load)(f);
+}
+
+static struct DoubleDouble NAME(power)(struct DoubleDouble a,
+                                       struct DoubleDouble b) {
+    struct DoubleDouble r = NAME(load)(1);
+    double p, slope;
+    if (b.lo == 0 && b.hi == floor(b.hi) && fabs(b.hi) <= 64) {
+        for (unsigned int e = fabs(b.hi); e; e >>= 1) {
+            if (e & 1) {
+                r = NAME(multiply)(r, a);
+            }
+            if (e > 1) {
+                a = NAME(multiply)(a, a);
+            }
+        }
+        return b.hi < 0 ? NAME(divide)(NAME(load)(1), r) : r;
+    }
+    p = pow(a.hi, b.hi);
+    if (!isfinite(p) || p == 0 || !(a.hi > 0)) {
+        return NAME(load)(p);
+    }
+    slope = p * (b.hi * a.lo / a.hi + log(a.hi) * b.lo);
+    return isfinite(slope) ? quick_sum(p, slope) : NAME(load)(p);
+}
+
+INLINE void NAME(unary)(int k,
+                        const struct DoubleDouble *x,
+                        struct DoubleDouble *y,
+                        size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        y[i] = NAME(function)(k, x[i]);
+    }
+}
+
+INLINE void NAME(pow)(const struct DoubleDouble *x,
+                      const struct DoubleDouble *y,
+                      struct DoubleDouble *z,
+                      size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        z[i] = NAME(power)(x[i], y[i]);
+    }
+}
+
+#include "evaluator.h"
+#undef PRECISION_TYPE
+#undef PRECISION_NAME
+
+void precision_evaluate_batch(const struct Program *program,
+                              int precision,
+                              int math,
+                              union Columns *columns,
+                              const double *in,
+                              double *out,
+                              size_t n) {
+    switch (precision) {
+    case PRECISION_FLOAT:
+        evaluate_float(program, columns->floats, in, out, n);
+        break;
+    case PRECISION_DOUBLE_DOUBLE:
+        evaluate_double_double(program,
+                               (struct DoubleDouble (*)[BLOCK])columns->pairs,
+                               in, out, n);
+        break;
+    default:
+        evaluate_double(program, math, columns->doubles, in, out, n);
+        break;
+    }
+}
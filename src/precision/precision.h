@@ -0,0 +1,20 @@
+#ifndef _PRECISION_H_
+#define _PRECISION_H_
+
+#include "../core/core.h"
+
+#define PRECISION_DOUBLE 0
+#define PRECISION_FLOAT 1
+#define PRECISION_DOUBLE_DOUBLE 2
+
+extern const char *precision_names[3];
+
+void precision_evaluate_batch(const struct Program *program,
+                              int precision,
+                              int math,
+                              union Columns *columns,
+                              const double *in,
+                              double *out,
+                              size_t n);
+
+#endif
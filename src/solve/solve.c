@@ -0,0 +1,353 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include "solve.h"
+
+#define ITERATIONS 100
+#define BLOCK_SAMPLES 32
+
+/*
+ * Samples the function on a uniform grid, skipping the inside of blocks
+ * that cannot hold what is searched for: a sign change when looking for
+ * roots, or a zero of the derivative when looking for extrema. Skipped
+ * samples repeat the previous value for roots and are interpolated
+ * between the block ends for extrema, which keeps them monotonic.
+ */
+static int sample_pruned(struct Context *context,
+                         double from,
+                         double to,
+                         unsigned long scan,
+                         char extrema,
+                         double **xs,
+                         double **ys,
+                         unsigned long *evaluations,
+                         unsigned long *enclosures) {
+    struct Bounds bounds;
+    double step = (to - from) / (scan - 1);
+    double *points, *values;
+    unsigned long n = 0, first, last;
+    char *pruned;
+    int ret = 1;
+    *xs = malloc(scan * sizeof(double));
+    *ys = malloc(scan * sizeof(double));
+    points = malloc(scan * sizeof(double));
+    values = malloc(scan * sizeof(double));
+    pruned = calloc(scan, 1);
+    if (!*xs || !*ys || !points || !values || !pruned) {
+        goto cleanup;
+    }
+    for (unsigned long i = 0; i < scan; ++i) {
+        (*xs)[i] = i == scan - 1 ? to : from + i * step;
+    }
+    for (first = 0; first + 1 < scan; first = last) {
+        last = first + BLOCK_SAMPLES < scan - 1 ? first + BLOCK_SAMPLES :
+                                                  scan - 1;
+        if (extrema) {
+            interval_derivative(&context->program, (*xs)[first], (*xs)[last],
+                                &bounds);
+        } else {
+            interval_evaluate(&context->program, (*xs)[first], (*xs)[last],
+                              &bounds);
+        }
+        ++*enclosures;
+        if (bounds.lo > 0 || bounds.hi < 0 || isnan(bounds.lo)) {
+            memset(pruned + first + 1, 1, last - first - 1);
+        }
+    }
+    for (unsigned long i = 0; i < scan; ++i) {
+        if (!pruned[i]) {
+            points[n++] = (*xs)[i];
+        }
+    }
+    ret = core_context_evaluate_batch(context, points, values, n);
+    if (ret) {
+        ret += 1;
+        goto cleanup;
+    }
+    *evaluations += n;
+    n = 0;
+    for (unsigned long i = 0; i < scan; ++i) {
+        if (!pruned[i]) {
+            (*ys)[i] = values[n++];
+        }
+    }
+    for (unsigned long i = 0; i < scan; ++i) {
+        if (!pruned[i]) {
+            continue;
+        }
+        if (!extrema) {
+            (*ys)[i] = (*ys)[i - 1];
+            continue;
+        }
+        first = i / BLOCK_SAMPLES * BLOCK_SAMPLES;
+        last = first + BLOCK_SAMPLES < scan - 1 ? first + BLOCK_SAMPLES :
+                                                  scan - 1;
+        (*ys)[i] = (*ys)[first] + ((*ys)[last] - (*ys)[first]) *
+                   (i - first) / (last - first);
+    }
+cleanup:
+    if (ret) {
+        free(*xs);
+        free(*ys);
+    }
+    free(points);
+    free(values);
+    free(pruned);
+    return ret;
+}
+
+/*
+ * Brent's method with a safeguarded Newton step: derivatives come from
+ * core_context_derivative, and the Newton step is taken whenever it stays
+ * inside the bracket and shrinks at least as fast as bisection would.
+ */
+static int brent(struct Context *context,
+                 double a,
+                 double b,
+                 double fa,
+                 double fb,
+                 double *root,
+                 unsigned long *evaluations) {
+    struct Dual y;
+    double c = b, fc = fb, d = b - a, e = d;
+    double da = NAN, db = NAN, dc = NAN;
+    double bound = fmin(fabs(fa), fabs(fb));
+    double tol, m, p, q, r, s;
+    int ret;
+    for (int i = 0; i < ITERATIONS; ++i) {
+        if ((fb > 0 && fc > 0) || (fb < 0 && fc < 0)) {
+            c = a;
+            fc = fa;
+            dc = da;
+            d = e = b - a;
+        }
+        if (fabs(fc) < fabs(fb)) {
+            a = b;
+            b = c;
+            c = a;
+            fa = fb;
+            fb = fc;
+            fc = fa;
+            da = db;
+            db = dc;
+            dc = da;
+        }
+        tol = 2 * DBL_EPSILON * fabs(b) + DBL_MIN;
+        m = (c - b) / 2;
+        if (fabs(m) <= tol || fb == 0) {
+            break;
+        }
+        p = -fb / db;
+        if (isfinite(p) && (p > 0) == (m > 0) &&
+            fabs(p) < fabs(2 * m) && fabs(2 * p) <= fabs(e)) {
+            e = d;
+            d = p;
+        } else if (fabs(e) >= tol && fabs(fa) > fabs(fb)) {
+            s = fb / fa;
+            if (a == c) {
+                p = 2 * m * s;
+                q = 1 - s;
+            } else {
+                q = fa / fc;
+                r = fb / fc;
+                p = s * (2 * m * q * (q - r) - (b - a) * (r - 1));
+                q = (q - 1) * (r - 1) * (s - 1);
+            }
+            if (p > 0) {
+                q = -q;
+            }
+            p = fabs(p);
+            if (2 * p < fmin(3 * m * q - fabs(tol * q), fabs(e * q))) {
+                e = d;
+                d = p / q;
+            } else {
+                d = e = m;
+            }
+        } else {
+            d = e = m;
+        }
+        a = b;
+        fa = fb;
+        da = db;
+        b += fabs(d) > tol ? d : m > 0 ? tol : -tol;
+        ret = core_context_derivative(context, b, &y);
+        ++*evaluations;
+        if (ret) {
+            return ret + 1;
+        }
+        fb = y.value;
+        db = y.first;
+        if (isnan(fb)) {
+            *root = NAN;
+            return 0;
+        }
+    }
+    *root = fabs(fb) <= bound ? b : NAN;
+    return 0;
+}
+
+int solve_roots(struct Context *context,
+                double from,
+                double to,
+                unsigned long scan,
+                double *roots,
+                size_t capacity,
+                size_t *count,
+                unsigned long *evaluations,
+                unsigned long *enclosures) {
+    double *xs, *ys;
+    double root = NAN;
+    int ret;
+    if (!count || !evaluations || !enclosures || (capacity && !roots)) {
+        return 1;
+    }
+    if (from >= to || scan < 2) {
+        return 2;
+    }
+    if (context->program.status) {
+        return context->program.status + 1;
+    }
+    *evaluations = 0;
+    *enclosures = 0;
+    ret = sample_pruned(context, from, to, scan, 0, &xs, &ys,
+                        evaluations, enclosures);
+    if (ret) {
+        return ret;
+    }
+    *count = 0;
+    for (unsigned long i = 0; i < scan; ++i) {
+        if (ys[i] == 0) {
+            root = xs[i];
+        } else if (i && ys[i - 1] != 0 &&
+                   ((ys[i - 1] < 0 && ys[i] > 0) ||
+                    (ys[i - 1] > 0 && ys[i] < 0))) {
+            ret = brent(context, xs[i - 1], xs[i], ys[i - 1], ys[i],
+                        &root, evaluations);
+            if (ret) {
+                break;
+            }
+            if (isnan(root)) {
+                continue;
+            }
+        } else {
+            continue;
+        }
+        if (*count < capacity) {
+            roots[*count] = root;
+        }
+        ++*count;
+    }
+    free(xs);
+    free(ys);
+    return ret;
+}
+
+static int newton(struct Context *context,
+                  double lo,
+                  double hi,
+                  struct Extremum *out,
+                  unsigned long *evaluations) {
+    struct Dual y;
+    double x = (lo + hi) / 2, dx = hi - lo, previous, next;
+    int ret;
+    for (int i = 0; i < ITERATIONS; ++i) {
+        ret = core_context_derivative(context, x, &y);
+        ++*evaluations;
+        if (ret) {
+            return ret + 1;
+        }
+        out->x = x;
+        out->y = y.value;
+        if (y.first == 0 || isnan(y.first)) {
+            break;
+        }
+        if (y.first < 0) {
+            lo = x;
+        } else {
+            hi = x;
+        }
+        previous = dx;
+        dx = y.first / y.second;
+        next = x - dx;
+        if (!isfinite(dx) || (next - lo) * (next - hi) >= 0 ||
+            fabs(2 * dx) > fabs(previous)) {
+            dx = (hi - lo) / 2;
+            next = lo + dx;
+        }
+        if (fabs(dx) <= 2 * DBL_EPSILON * fabs(x) + DBL_MIN) {
+            break;
+        }
+        x = next;
+    }
+    return 0;
+}
+
+int solve_extrema(struct Context *context,
+                  double from,
+                  double to,
+                  unsigned long scan,
+                  struct Extremum *extrema,
+                  size_t capacity,
+                  size_t *count,
+                  unsigned long *evaluations,
+                  unsigned long *enclosures) {
+    struct Extremum extremum;
+    struct Dual left, right;
+    double *xs, *ys;
+    int ret;
+    if (!count || !evaluations || !enclosures || (capacity && !extrema)) {
+        return 1;
+    }
+    if (from >= to || scan < 3) {
+        return 2;
+    }
+    if (context->program.status) {
+        return context->program.status + 1;
+    }
+    *evaluations = 0;
+    *enclosures = 0;
+    ret = sample_pruned(context, from, to, scan, 1, &xs, &ys,
+                        evaluations, enclosures);
+    if (ret) {
+        return ret;
+    }
+    *count = 0;
+    for (unsigned long i = 1; i + 1 < scan; ++i) {
+        if (ys[i - 1] < ys[i] && ys[i] >= ys[i + 1]) {
+            extremum.maximum = 1;
+        } else if (ys[i - 1] > ys[i] && ys[i] <= ys[i + 1]) {
+            extremum.maximum = 0;
+        } else {
+            continue;
+        }
+        extremum.x = xs[i];
+        extremum.y = ys[i];
+        ret = core_context_derivative(context, xs[i - 1], &left);
+        if (!ret) {
+            ret = core_context_derivative(context, xs[i + 1], &right);
+        }
+        *evaluations += 2;
+        if (ret) {
+            ret += 1;
+            break;
+        }
+        if (left.first < 0 && right.first > 0) {
+            ret = newton(context, xs[i - 1], xs[i + 1],
+                         &extremum, evaluations);
+        } else if (left.first > 0 && right.first < 0) {
+            ret = newton(context, xs[i + 1], xs[i - 1],
+                         &extremum, evaluations);
+        }
+        if (ret) {
+            break;
+        }
+        if (*count < capacity) {
+            extrema[*count] = extremum;
+        }
+        ++*count;
+    }
+    free(xs);
+    free(ys);
+    return ret;
+}
@@ -0,0 +1,34 @@
+#ifndef _SOLVE_H_
+#define _SOLVE_H_
+
+#include <stddef.h>
+#include "../core/core.h"
+
+#define SOLVE_SCAN 1024
+
+struct Extremum {
+    double x;
+    double y;
+    char maximum;
+};
+
+int solve_roots(struct Context *context,
+                double from,
+                double to,
+                unsigned long scan,
+                double *roots,
+                size_t capacity,
+                size_t *count,
+                unsigned long *evaluations,
+                unsigned long *enclosures);
+int solve_extrema(struct Context *context,
+                  double from,
+                  double to,
+                  unsigned long scan,
+                  struct Extremum *extrema,
+                  size_t capacity,
+                  size_t *count,
+                  unsigned long *evaluations,
+                  unsigned long *enclosures);
+
+#endif
@@ -0,0 +1,107 @@
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "stats.h"
+#include "../core/core.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+struct Stats stats;
+
+unsigned long long stats_clock(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+double stats_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void stats_results(const double *values, size_t n) {
+    unsigned long long nans = 0, infs = 0;
+    for (size_t i = 0; i < n; ++i) {
+        nans += isnan(values[i]) != 0;
+        infs += isinf(values[i]) != 0;
+    }
+    __atomic_fetch_add(&stats.evaluations, n, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stats.nans, nans, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stats.infs, infs, __ATOMIC_RELAXED);
+}
+
+void stats_loads(int op,
+                 unsigned a,
+                 unsigned b,
+                 unsigned pinned,
+                 unsigned long long n) {
+    unsigned long long inputs = !a, numbers = a && a < pinned;
+    if (op >= OP_BINARY) {
+        inputs += !b;
+        numbers += b && b < pinned;
+    }
+    if (inputs) {
+        __atomic_fetch_add(&stats.counts[OP_INPUT], inputs * n,
+                           __ATOMIC_RELAXED);
+    }
+    if (numbers) {
+        __atomic_fetch_add(&stats.counts[OP_NUMBER], numbers * n,
+                           __ATOMIC_RELAXED);
+    }
+}
+
+void stats_reset(void) {
+    memset(&stats, 0, sizeof(struct Stats));
+}
+
+const char *stats_name(int op) {
+    switch (op) {
+    case OP_INPUT:
+        return "Input";
+    case OP_NUMBER:
+        return "Number";
+    case OP_DUP:
+        return "Dup";
+    default:
+        if (op >= OP_BINARY) {
+            return binary_names[op - OP_BINARY];
+        }
+        return unary_names[op - OP_UNARY];
+    }
+}
+
+void stats_dump(FILE *fout) {
+    const struct Memo *memo = &default_context.memo;
+    fprintf(fout, "Cache %llu hits %llu misses %llu evictions\n",
+            memo->hits, memo->misses, memo->evictions);
+    if (default_context.polynomial.degree >= 0) {
+        fprintf(fout, "Polynomial degree %d\n",
+                default_context.polynomial.degree);
+    }
+    if (!STATS_ENABLED) {
+        fputs("Statistics not compiled in (build with make STATS=1)\n", fout);
+        return;
+    }
+    fprintf(fout, "%-8s %16s %16s %10s\n", "Op", "Count", "Cycles", "Cycles/op");
+    for (int i = 0; i < STATS_OPS; ++i) {
+        if (!stats.counts[i]) {
+            continue;
+        }
+        fprintf(fout, "%-8s %16llu %16llu %10.1f\n",
+                stats_name(i), stats.counts[i], stats.cycles[i],
+                (double)stats.cycles[i] / stats.counts[i]);
+    }
+    fprintf(fout, "Evaluations %llu NaN %llu Inf %llu\n",
+            stats.evaluations, stats.nans, stats.infs);
+    fprintf(fout, "Integrate %llu calls %.6f s\n",
+            stats.integrations, stats.integrate_seconds);
+    fprintf(fout, "Plot %llu calls %.6f s\n",
+            stats.plots, stats.plot_seconds);
+}
@@ -0,0 +1,67 @@
+#ifndef _STATS_H_
+#define _STATS_H_
+
+#include <stdio.h>
+#include <stddef.h>
+
+#define STATS_OPS 20
+
+struct Stats {
+    unsigned long long counts[STATS_OPS];
+    unsigned long long cycles[STATS_OPS];
+    unsigned long long evaluations;
+    unsigned long long nans;
+    unsigned long long infs;
+    unsigned long long integrations;
+    unsigned long long plots;
+    double integrate_seconds;
+    double plot_seconds;
+};
+
+extern struct Stats stats;
+
+unsigned long long stats_clock(void);
+double stats_seconds(void);
+void stats_results(const double *values, size_t n);
+void stats_loads(int op,
+                 unsigned a,
+                 unsigned b,
+                 unsigned pinned,
+                 unsigned long long n);
+void stats_reset(void);
+void stats_dump(FILE *fout);
+const char *stats_name(int op);
+
+#ifdef STATS
+#define STATS_ENABLED 1
+#define STATS_ADD(field, value) \
+    __atomic_fetch_add(&stats.field, (value), __ATOMIC_RELAXED)
+#define STATS_BEGIN(name) unsigned long long name = stats_clock()
+#define STATS_RESTART(name) name = stats_clock()
+#define STATS_OP(op, n, begin) \
+    do { \
+        STATS_ADD(counts[op], (n)); \
+        STATS_ADD(cycles[op], stats_clock() - (begin)); \
+    } while (0)
+#define STATS_LOADS(op, a, b, pinned, n) \
+    stats_loads((op), (a), (b), (pinned), (n))
+#define STATS_RESULTS(values, n) stats_results((values), (n))
+#define STATS_TIMER(name) double name = stats_seconds()
+#define STATS_ELAPSED(field, counter, begin) \
+    do { \
+        stats.field += stats_seconds() - (begin); \
+        STATS_ADD(counter, 1); \
+    } while (0)
+#else
+#define STATS_ENABLED 0
+#define STATS_ADD(field, value) do {} while (0)
+#define STATS_BEGIN(name) do {} while (0)
+#define STATS_RESTART(name) do {} while (0)
+#define STATS_OP(op, n, begin) do {} while (0)
+#define STATS_LOADS(op, a, b, pinned, n) do {} while (0)
+#define STATS_RESULTS(values, n) do {} while (0)
+#define STATS_TIMER(name) do {} while (0)
+#define STATS_ELAPSED(field, counter, begin) do {} while (0)
+#endif
+
+#endif
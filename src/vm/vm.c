@@ -0,0 +1,192 @@
+#include "../core/core.h"
+#include "../stats/stats.h"
+#include "../vmath/vmath.h"
+#include "vm.h"
+
+#pragma GCC optimize("fp-contract=off")
+
+static int reads(const struct Program *program, unsigned char i) {
+    unsigned char t = program->dst[i];
+    int count = 0;
+    for (unsigned char j = i + 1; j < program->code_length; ++j) {
+        count += program->a[j] == t;
+        if (program->code[j] >= OP_BINARY) {
+            count += program->b[j] == t;
+        }
+        if (program->dst[j] == t) {
+            return count;
+        }
+    }
+    return count + (program->result == t);
+}
+
+static char fuse(const struct Program *program,
+                 unsigned char i,
+                 struct Instruction *op) {
+    unsigned char t = program->dst[i];
+    unsigned char next = program->code[i + 1];
+    unsigned char other;
+    char first;
+    if (next < OP_BINARY || reads(program, i) != 1) {
+        return 0;
+    }
+    if (program->a[i + 1] == t) {
+        other = program->b[i + 1];
+        first = 1;
+    } else if (program->b[i + 1] == t) {
+        other = program->a[i + 1];
+        first = 0;
+    } else {
+        return 0;
+    }
+    if (program->code[i] == OP_MULTIPLY && next == OP_ADD) {
+        op->code = VM_MULADD;
+    } else if (program->code[i] == OP_MULTIPLY &&
+               next == OP_SUBTRACT && first) {
+        op->code = VM_MULSUB;
+    } else if (program->code[i] < OP_BINARY && next == OP_MULTIPLY) {
+        op->code = VM_SCALE;
+        op->b = other;
+        op->c = program->code[i] - OP_UNARY;
+        op->dst = program->dst[i + 1];
+        return 1;
+    } else {
+        return 0;
+    }
+    op->c = other;
+    op->dst = program->dst[i + 1];
+    return 1;
+}
+
+static void specialize(struct Instruction *op) {
+    unsigned char swap;
+    if (op->code == OP_MULTIPLY && op->a == op->b) {
+        op->code = VM_SQUARE;
+        return;
+    }
+    if ((op->code == OP_ADD || op->code == OP_MULTIPLY) && op->b == 0) {
+        swap = op->a;
+        op->a = op->b;
+        op->b = swap;
+    }
+    if (op->a) {
+        return;
+    }
+    if (op->code < OP_BINARY) {
+        op->c = op->code - OP_UNARY;
+        op->code = VM_UNARY_X;
+    } else if (op->code != OP_POW) {
+        op->code = VM_ADD_X + op->code - OP_ADD;
+    }
+}
+
+int vm_compile(struct Vm *vm, const struct Program *program) {
+    struct Instruction *op;
+    vm->length = 0;
+    vm->pinned = program->pinned;
+    vm->result = program->result;
+    vm->fused = 0;
+    for (unsigned char i = 0; i < program->code_length; ++i) {
+        op = vm->code + vm->length++;
+        op->code = program->code[i];
+        op->dst = program->dst[i];
+        op->a = program->a[i];
+        op->b = program->b[i];
+        op->c = 0;
+        if (STATS_ENABLED) {
+            continue;
+        }
+        if (i + 1 < program->code_length && fuse(program, i, op)) {
+            ++vm->fused;
+            ++i;
+            continue;
+        }
+        specialize(op);
+    }
+    vm->code[vm->length].code = VM_RETURN;
+    return vm->fused;
+}
+
+#define NEXT \
+    do { \
+        STATS_OP(ii->code, 1, begin); \
+        STATS_LOADS(ii->code, ii->a, ii->b, vm->pinned, 1); \
+        STATS_RESTART(begin); \
+        ++ii; \
+        goto *labels[ii->code]; \
+    } while (0)
+
+double vm_run(const struct Vm *vm, int math, double *r, double in) {
+    static const void *const labels[VM_OPS] = {
+        [OP_INPUT ... OP_DUP] = &&done,
+        [OP_UNARY ... OP_BINARY - 1] = &&unary,
+        [OP_ADD] = &&add,
+        [OP_SUBTRACT] = &&subtract,
+        [OP_MULTIPLY] = &&multiply,
+        [OP_DIVIDE] = &&divide,
+        [OP_POW] = &&power,
+        [VM_MULADD] = &&muladd,
+        [VM_MULSUB] = &&mulsub,
+        [VM_SQUARE] = &&square,
+        [VM_SCALE] = &&scale,
+        [VM_UNARY_X] = &&unary_x,
+        [VM_ADD_X] = &&add_x,
+        [VM_SUBTRACT_X] = &&subtract_x,
+        [VM_MULTIPLY_X] = &&multiply_x,
+        [VM_DIVIDE_X] = &&divide_x,
+        [VM_RETURN] = &&done
+    };
+    double (*const *functions)(double) = vmath_scalar[math];
+    double (*pow_function)(double, double) = vmath_scalar_pow[math];
+    const struct Instruction *ii = vm->code;
+    STATS_BEGIN(begin);
+    r[0] = in;
+    goto *labels[ii->code];
+unary:
+    r[ii->dst] = functions[ii->code - OP_UNARY](r[ii->a]);
+    NEXT;
+add:
+    r[ii->dst] = r[ii->a] + r[ii->b];
+    NEXT;
+subtract:
+    r[ii->dst] = r[ii->a] - r[ii->b];
+    NEXT;
+multiply:
+    r[ii->dst] = r[ii->a] * r[ii->b];
+    NEXT;
+divide:
+    r[ii->dst] = r[ii->a] / r[ii->b];
+    NEXT;
+power:
+    r[ii->dst] = pow_function(r[ii->a], r[ii->b]);
+    NEXT;
+muladd:
+    r[ii->dst] = r[ii->a] * r[ii->b] + r[ii->c];
+    NEXT;
+mulsub:
+    r[ii->dst] = r[ii->a] * r[ii->b] - r[ii->c];
+    NEXT;
+square:
+    r[ii->dst] = r[ii->a] * r[ii->a];
+    NEXT;
+scale:
+    r[ii->dst] = r[ii->b] * functions[ii->c](r[ii->a]);
+    NEXT;
+unary_x:
+    r[ii->dst] = functions[ii->c](in);
+    NEXT;
+add_x:
+    r[ii->dst] = in + r[ii->b];
+    NEXT;
+subtract_x:
+    r[ii->dst] = in - r[ii->b];
+    NEXT;
+multiply_x:
+    r[ii->dst] = in * r[ii->b];
+    NEXT;
+divide_x:
+    r[ii->dst] = in / r[ii->b];
+    NEXT;
+done:
+    return r[vm->result];
+}
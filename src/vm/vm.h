@@ -0,0 +1,37 @@
+#ifndef _VM_H_
+#define _VM_H_
+
+#define VM_MULADD 20
+#define VM_MULSUB 21
+#define VM_SQUARE 22
+#define VM_SCALE 23
+#define VM_UNARY_X 24
+#define VM_ADD_X 25
+#define VM_SUBTRACT_X 26
+#define VM_MULTIPLY_X 27
+#define VM_DIVIDE_X 28
+#define VM_RETURN 29
+#define VM_OPS 30
+
+struct Program;
+
+struct Instruction {
+    unsigned char code;
+    unsigned char dst;
+    unsigned char a;
+    unsigned char b;
+    unsigned char c;
+};
+
+struct Vm {
+    struct Instruction code[101];
+    unsigned char length;
+    unsigned char pinned;
+    unsigned char result;
+    int fused;
+};
+
+int vm_compile(struct Vm *vm, const struct Program *program);
+double vm_run(const struct Vm *vm, int math, double *registers, double in);
+
+#endif
@@ -0,0 +1,661 @@
+/*
+ * Vector kernels, included once per instruction set by vmath.c with
+ * VMATH_ISA, VMATH_WIDTH, VMATH_SQRT and optionally VMATH_FMA defined.
+ */
+
+#define CAT_(a, b) a##_##b
+#define CAT(a, b) CAT_(a, b)
+#define NAME(name) CAT(name, VMATH_ISA)
+#define V NAME(vd)
+#define VI NAME(vi)
+#define VU NAME(vu)
+#define INLINE static inline __attribute__((always_inline))
+
+typedef double V __attribute__((vector_size(VMATH_WIDTH * 8)));
+typedef long VI __attribute__((vector_size(VMATH_WIDTH * 8)));
+typedef unsigned long VU __attribute__((vector_size(VMATH_WIDTH * 8)));
+
+INLINE V NAME(splat)(double c) {
+    return c - (V){};
+}
+
+INLINE V NAME(select)(VI mask, V a, V b) {
+    return (V)((mask & (VI)a) | (~mask & (VI)b));
+}
+
+INLINE V NAME(negate)(VI mask, V a) {
+    return (V)((VI)a ^ (mask & LONG_MIN));
+}
+
+INLINE V NAME(round)(V x) {
+    return (x + MAGIC) - MAGIC;
+}
+
+INLINE VI NAME(to_int)(V k) {
+    return (VI)(k + MAGIC) - (VI)NAME(splat)(MAGIC);
+}
+
+INLINE V NAME(to_double)(VI k) {
+    return (V)((VI)NAME(splat)(MAGIC) + k) - MAGIC;
+}
+
+INLINE V NAME(scale)(VI k) {
+    return (V)((k + 1023) << 52);
+}
+
+/* Evaluates c[0] + c[1] x + ... as two interleaved chains in x^2. */
+INLINE V NAME(horner)(V x, const double *c, int n) {
+    V x2 = x * x;
+    V even = NAME(splat)(c[(n - 1) & ~1]);
+    V odd = NAME(splat)(n > 1 ? c[(n - 2) | 1] : 0.0);
+#pragma GCC unroll 8
+    for (int i = ((n - 1) & ~1) - 2; i >= 0; i -= 2) {
+        even = even * x2 + c[i];
+    }
+#pragma GCC unroll 8
+    for (int i = ((n - 2) | 1) - 2; i >= 1; i -= 2) {
+        odd = odd * x2 + c[i];
+    }
+    return even + x * odd;
+}
+
+INLINE V NAME(two_product)(V a, V b, V p) {
+#ifdef VMATH_FMA
+    return VMATH_FMA(a, b, -p);
+#else
+    V c = a * SPLITTER;
+    V ah = c - (c - a);
+    V al = a - ah;
+    c = b * SPLITTER;
+    V bh = c - (c - b);
+    V bl = b - bh;
+    return ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+#endif
+}
+
+INLINE V NAME(fallback)(V x, V y, VI bad, double (*f)(double)) {
+    for (int i = 0; i < VMATH_WIDTH; ++i) {
+        if (bad[i]) {
+            y[i] = f(x[i]);
+        }
+    }
+    return y;
+}
+
+INLINE V NAME(expm1_reduced)(V r, int fast) {
+    return r + r * r * NAME(horner)(r, expm1_coefficients,
+                                    (fast ? EXP_FAST : EXP_ULP) - 1);
+}
+
+INLINE V NAME(exp_scaled)(V y, V k) {
+    VI ki = NAME(to_int)(k);
+    VI k1 = ((ki + 2048) >> 1) - 1024;
+    return y * NAME(scale)(k1) * NAME(scale)(ki - k1);
+}
+
+/* Reduces x to k ln2 / 128 + r with |r| <= ln2 / 256. */
+INLINE V NAME(exp_reduce)(V x, VI *k) {
+    V kk = NAME(round)(x * (128 * LOG2E));
+    *k = NAME(to_int)(kk);
+    return (x - kk * (LN2HI / 128)) - kk * (LN2LO / 128);
+}
+
+/*
+ * Returns 2^(k / 128) * exp(r + tail) / 2^(k >> 7) as the table entry plus
+ * *lo, leaving the final rounding to the caller.
+ */
+INLINE V NAME(exp_table)(VI k, V r, V tail, V *lo) {
+    V h, t;
+    for (int i = 0; i < VMATH_WIDTH; ++i) {
+        h[i] = exp_table[k[i] & 127][0];
+        t[i] = exp_table[k[i] & 127][1];
+    }
+    V s = r + tail;
+    V p = s + (((r - s) + tail) +
+               s * s * NAME(horner)(s, expm1_coefficients, 5));
+    *lo = t + h * p;
+    return h;
+}
+
+/* Returns exp(x + tail) * 2^shift without rounding the shift into x. */
+INLINE V NAME(exp_accurate)(V x, V tail, double shift) {
+    VI k;
+    V lo;
+    V r = NAME(exp_reduce)(x, &k);
+    V h = NAME(exp_table)(k, r, tail, &lo);
+    return NAME(exp_scaled)(h + lo, NAME(to_double)(k >> 7) + shift);
+}
+
+/* Returns exp(x) * 2^shift without rounding the shift into x. */
+INLINE V NAME(exp_shifted)(V x, double shift, int fast) {
+    x = NAME(select)(x > 711.0, NAME(splat)(711.0), x);
+    x = NAME(select)(x < -746.0, NAME(splat)(-746.0), x);
+    if (!fast) {
+        return NAME(exp_accurate)(x, NAME(splat)(0.0), shift);
+    }
+    V k = NAME(round)(x * LOG2E);
+    V r = (x - k * LN2HI) - k * LN2LO;
+    return NAME(exp_scaled)(1.0 + NAME(expm1_reduced)(r, fast), k + shift);
+}
+
+/* Returns exp(x) as hi + *lo for |x| <= 45. */
+INLINE V NAME(exp_dd)(V x, V *lo) {
+    VI k;
+    V r = NAME(exp_reduce)(x, &k);
+    V t = NAME(exp_table)(k, r, NAME(splat)(0.0), lo);
+    V s = NAME(scale)(k >> 7);
+    V h = t + *lo;
+    *lo = ((t - h) + *lo) * s;
+    return h * s;
+}
+
+/* Returns n / (h + l) as the quotient plus *tail. */
+INLINE V NAME(quotient)(double n, V h, V l, V *tail) {
+    V q = n / h;
+    V p = h * q;
+    V e = NAME(two_product)(h, q, p);
+    *tail = (((n - p) - e) - l * q) / h;
+    return q;
+}
+
+INLINE V NAME(exp_v)(V x, int fast) {
+    return NAME(exp_shifted)(x, 0.0, fast);
+}
+
+INLINE V NAME(exp2_v)(V x, int fast) {
+    x = NAME(select)(x > 1025.0, NAME(splat)(1025.0), x);
+    x = NAME(select)(x < -1076.0, NAME(splat)(-1076.0), x);
+    if (!fast) {
+        V kk = NAME(round)(x * 128);
+        V r = x - kk * (1.0 / 128);
+        V h = r * LN2;
+        V t = NAME(two_product)(r, NAME(splat)(LN2), h) + r * LN2_TAIL;
+        VI k = NAME(to_int)(kk);
+        V lo;
+        h = NAME(exp_table)(k, h, t, &lo);
+        return NAME(exp_scaled)(h + lo, NAME(to_double)(k >> 7));
+    }
+    V k = NAME(round)(x);
+    V r = x - k;
+    V p = r * NAME(horner)(r, exp2_coefficients,
+                           fast ? EXP_FAST : EXP_ULP);
+    return NAME(exp_scaled)(1.0 + p, k);
+}
+
+INLINE V NAME(expm1_v)(V x, int fast) {
+    x = NAME(select)(x > 45.0, NAME(splat)(45.0), x);
+    x = NAME(select)(x < -45.0, NAME(splat)(-45.0), x);
+    V k = NAME(round)(x * LOG2E);
+    V r = (x - k * LN2HI) - k * LN2LO;
+    V s = NAME(scale)(NAME(to_int)(k));
+    return s * NAME(expm1_reduced)(r, fast) + (s - 1.0);
+}
+
+/* Splits x into k + log(1 + f) with 1 + f in [sqrt(2)/2, sqrt(2)). */
+INLINE V NAME(log_reduce)(V x, V *k) {
+    VI tiny = x < 0x1p-1022;
+    x = NAME(select)(tiny, x * 0x1p54, x);
+    VU bits = (VU)x;
+    VU high = (bits >> 32) + (0x3ff00000 - 0x3fe6a09e);
+    *k = NAME(to_double)((VI)(high >> 20) - 0x3ff) -
+         NAME(select)(tiny, NAME(splat)(54.0), NAME(splat)(0.0));
+    high = (high & 0x000fffff) + 0x3fe6a09e;
+    return (V)((high << 32) | (bits & 0xffffffff)) - 1.0;
+}
+
+INLINE V NAME(log_series)(V f, V *s, int fast) {
+    V z, w;
+    *s = f / (2.0 + f);
+    z = *s * *s;
+    w = z * z;
+    if (fast) {
+        return z * (LG1 + w * (LG3 + w * LG5)) + w * (LG2 + w * (LG4 + w * LG6));
+    }
+    return z * (LG1 + w * (LG3 + w * (LG5 + w * LG7))) +
+           w * (LG2 + w * (LG4 + w * LG6));
+}
+
+INLINE V NAME(log_special)(V x, V y) {
+    VI ok = (x > 0.0) & (x < INFINITY);
+    V special = NAME(select)(x == 0.0, NAME(splat)(-INFINITY),
+                             NAME(select)(x < 0.0, NAME(splat)(NAN), x));
+    return NAME(select)(ok, y, special);
+}
+
+INLINE V NAME(log_v)(V x, int fast) {
+    V k, s;
+    V f = NAME(log_reduce)(x, &k);
+    V r = NAME(log_series)(f, &s, fast);
+    V hfsq = 0.5 * f * f;
+    V y;
+    if (fast) {
+        y = k * LN2 + (f - hfsq + s * (hfsq + r));
+    } else {
+        y = k * LN2HI - ((hfsq - (s * (hfsq + r) + k * LN2LO)) - f);
+    }
+    return NAME(log_special)(x, y);
+}
+
+/* Evaluates k * scale + log(1 + f) * inverse with the inverse split in two. */
+INLINE V NAME(log_scaled)(V x,
+                          int fast,
+                          double scale_hi,
+                          double scale_lo,
+                          double inverse_hi,
+                          double inverse_lo) {
+    V k, s;
+    V f = NAME(log_reduce)(x, &k);
+    V r = NAME(log_series)(f, &s, fast);
+    V hfsq = 0.5 * f * f;
+    V y, hi, lo, w, yh;
+    if (fast) {
+        y = k * (scale_hi + scale_lo) +
+            (f - hfsq + s * (hfsq + r)) * (inverse_hi + inverse_lo);
+        return NAME(log_special)(x, y);
+    }
+    hi = (V)((VU)(f - hfsq) & 0xffffffff00000000UL);
+    lo = (f - hi) - hfsq + s * (hfsq + r);
+    yh = k * scale_hi;
+    y = hi * inverse_hi;
+    lo = k * scale_lo + (lo + hi) * inverse_lo + lo * inverse_hi;
+    w = yh + y;
+    lo += (yh - w) + y;
+    return NAME(log_special)(x, lo + w);
+}
+
+/* Returns log(x) as hi + *lo for positive finite x, using log_table. */
+INLINE V NAME(log_dd)(V x, V *lo) {
+    VI tiny = x < 0x1p-1022;
+    x = NAME(select)(tiny, x * 0x1p54, x);
+    VU bits = (VU)x;
+    V k = NAME(to_double)((VI)(bits >> 52) - 1023) -
+          NAME(select)(tiny, NAME(splat)(54.0), NAME(splat)(0.0));
+    V m = (V)((bits & 0x000fffffffffffffUL) | 0x3ff0000000000000UL);
+    VU index = (bits >> 45) & 127;
+    V inverse, th, tl;
+    for (int i = 0; i < VMATH_WIDTH; ++i) {
+        inverse[i] = log_table[index[i]][0];
+        th[i] = log_table[index[i]][1];
+        tl[i] = log_table[index[i]][2];
+    }
+    V p = m * inverse;
+    V pe = NAME(two_product)(m, inverse, p);
+    V r = (p - 1.0) + pe;
+    V rl = pe - (r - (p - 1.0));
+    V q = r * r * NAME(horner)(r, log1p_coefficients, 7);
+    V a = k * LN2HI;
+    V s1 = a + th;
+    V e1 = (a - (s1 - th)) + (th - (s1 - (s1 - th)));
+    V s2 = s1 + r;
+    V e2 = (s1 - (s2 - r)) + (r - (s2 - (s2 - r)));
+    V l = e1 + e2 + rl + q + k * LN2LO + tl;
+    V h = s2 + l;
+    *lo = l - (h - s2);
+    return h;
+}
+
+/* sin(r + t) for |r| <= pi/4, where t is the tail left by the reduction. */
+INLINE V NAME(sin_kernel)(V r, V t, V z, int fast) {
+    V p = S2 + z * (S3 + z * (S4 + z * (S5 + z * S6)));
+    if (fast) {
+        return r + r * z * (S1 + z * p);
+    }
+    return r + (r * z * (S1 + z * p) + t * (1.0 - 0.5 * z));
+}
+
+INLINE V NAME(cos_kernel)(V r, V t, V z, int fast) {
+    V hz = 0.5 * z;
+    V w = 1.0 - hz;
+    V p = C1 + z * (C2 + z * (C3 + z * (C4 + z * (C5 + z * C6))));
+    if (fast) {
+        return w + z * z * p;
+    }
+    return w + (((1.0 - w) - hz) + (z * z * p - r * t));
+}
+
+/*
+ * Reduces x by multiples of pi/2 into r + *t, flagging lanes too large for
+ * the three-part Cody-Waite reduction to stay exact.
+ */
+INLINE V NAME(trig_reduce)(V x, V *t, VI *q, VI *bad, int fast) {
+    V k = NAME(round)(x * INVPIO2);
+    V ax = NAME(select)(x < 0.0, -x, x);
+    V a, b, w, r;
+    *bad = ~(ax <= TRIG_LIMIT);
+    *q = NAME(to_int)(NAME(select)(*bad, NAME(splat)(0.0), k)) & 3;
+    if (fast) {
+        *t = NAME(splat)(0.0);
+        return (x - k * PIO2_1) - k * PIO2_1T;
+    }
+    a = x - k * PIO2_1;
+    b = k * PIO2_2;
+    w = a - b;
+    r = w - k * PIO2_3;
+    *t = ((a - w) - b) + ((w - r) - k * PIO2_3);
+    return r;
+}
+
+INLINE V NAME(sin_v)(V x, int fast) {
+    VI q, bad;
+    V t;
+    V r = NAME(trig_reduce)(x, &t, &q, &bad, fast);
+    V z = r * r;
+    V y = NAME(select)((q & 1) == 1, NAME(cos_kernel)(r, t, z, fast),
+                       NAME(sin_kernel)(r, t, z, fast));
+    y = NAME(negate)((q & 2) == 2, y);
+    y = NAME(select)(x == 0.0, x, y);
+    return NAME(fallback)(x, y, bad, sin);
+}
+
+INLINE V NAME(cos_v)(V x, int fast) {
+    VI q, bad;
+    V t;
+    V r = NAME(trig_reduce)(x, &t, &q, &bad, fast);
+    V z = r * r;
+    V y = NAME(select)((q & 1) == 1, NAME(sin_kernel)(r, t, z, fast),
+                       NAME(cos_kernel)(r, t, z, fast));
+    y = NAME(negate)(((q + 1) & 2) == 2, y);
+    return NAME(fallback)(x, y, bad, cos);
+}
+
+/*
+ * tan(x + y) for |x| <= pi/4, or -1 / tan(x + y) in odd lanes, following
+ * fdlibm: near pi/4 the argument is reflected, and the reciprocal is
+ * corrected with a split quotient.
+ */
+INLINE V NAME(tan_kernel)(V x, V y, VI odd) {
+    const double *c = tan_coefficients;
+    VI negative = x < 0.0;
+    VI reflect = NAME(select)(negative, -x, x) >= TAN_REFLECT;
+    V sign = NAME(select)(negative, NAME(splat)(-1.0), NAME(splat)(1.0));
+    V iy = NAME(select)(odd, NAME(splat)(-1.0), NAME(splat)(1.0));
+    V z, w, r, v, s, a, zh, th, reflected, inverted;
+    z = (PIO4 - sign * x) + (PIO4LO - sign * y);
+    x = NAME(select)(reflect, z, x);
+    y = NAME(select)(reflect, NAME(splat)(0.0), y);
+    z = x * x;
+    w = z * z;
+    r = c[1] + w * (c[3] + w * (c[5] + w * (c[7] + w * (c[9] + w * c[11]))));
+    v = z * (c[2] + w * (c[4] + w * (c[6] + w * (c[8] + w * (c[10] +
+                                                             w * c[12])))));
+    s = z * x;
+    r = y + z * (s * (r + v) + y);
+    r += c[0] * s;
+    w = x + r;
+    reflected = sign * (iy - 2.0 * (x - (w * w / (w + iy) - r)));
+    zh = (V)((VU)w & 0xffffffff00000000UL);
+    v = r - (zh - x);
+    a = -1.0 / w;
+    th = (V)((VU)a & 0xffffffff00000000UL);
+    inverted = th + a * ((1.0 + th * zh) + th * v);
+    return NAME(select)(reflect, reflected, NAME(select)(odd, inverted, w));
+}
+
+INLINE V NAME(tan_v)(V x, int fast) {
+    VI q, bad;
+    V t;
+    V r = NAME(trig_reduce)(x, &t, &q, &bad, fast);
+    V z = r * r;
+    VI odd = (q & 1) == 1;
+    V s, c, y;
+    if (fast) {
+        s = NAME(sin_kernel)(r, t, z, fast);
+        c = NAME(cos_kernel)(r, t, z, fast);
+        y = NAME(select)(odd, -c, s) / NAME(select)(odd, s, c);
+    } else {
+        y = NAME(tan_kernel)(r, t, odd);
+    }
+    y = NAME(select)(x == 0.0, x, y);
+    return NAME(fallback)(x, y, bad, tan);
+}
+
+INLINE V NAME(sinh_v)(V x, int fast) {
+    VI negative = x < 0.0;
+    V ax = NAME(select)(negative, -x, x);
+    V t, small, medium, large, y, h, l, inverse, tail, z;
+    if (fast) {
+        t = NAME(expm1_v)(ax, fast);
+        small = 0.5 * (2.0 * t - t * t / (t + 1.0));
+        medium = 0.5 * (t + t / (t + 1.0));
+    } else {
+        z = ax * ax;
+        small = ax + ax * z * NAME(horner)(z, sinh_coefficients, 9);
+        h = NAME(exp_dd)(NAME(select)(ax < 22.0, ax, NAME(splat)(22.0)), &l);
+        inverse = NAME(quotient)(1.0, h, l, &tail);
+        t = h - inverse;
+        medium = 0.5 * (t + (((h - t) - inverse) + (l - tail)));
+    }
+    large = NAME(exp_shifted)(ax, -1.0, fast);
+    y = NAME(select)(ax < 1.0, small,
+                     NAME(select)(ax < 22.0, medium, large));
+    y = NAME(select)((x == x) & (x != 0.0), y, x);
+    return NAME(negate)(negative, y);
+}
+
+INLINE V NAME(cosh_v)(V x, int fast) {
+    V ax = NAME(select)(x < 0.0, -x, x);
+    V e, t, small, medium, large, y, h, l, inverse, tail;
+    large = NAME(exp_shifted)(ax, -1.0, fast);
+    if (fast) {
+        e = NAME(exp_v)(ax, fast);
+        t = NAME(expm1_v)(ax, fast);
+        small = 1.0 + (t * t) / (2.0 * (1.0 + t));
+        medium = 0.5 * e + 0.5 / e;
+        y = NAME(select)(ax < LN2 / 2, small,
+                         NAME(select)(ax < 22.0, medium, large));
+    } else {
+        h = NAME(exp_dd)(NAME(select)(ax < 22.0, ax, NAME(splat)(22.0)), &l);
+        inverse = NAME(quotient)(1.0, h, l, &tail);
+        t = h + inverse;
+        medium = 0.5 * (t + (((h - t) + inverse) + (l + tail)));
+        y = NAME(select)(ax < 22.0, medium, large);
+    }
+    return NAME(select)(x == x, y, x);
+}
+
+INLINE V NAME(tanh_v)(V x, int fast) {
+    VI negative = x < 0.0;
+    V ax = NAME(select)(negative, -x, x);
+    V t, u, y, z, h, l, d, q, tail, s;
+    if (fast) {
+        t = NAME(expm1_v)(2.0 * ax, fast);
+        u = NAME(expm1_v)(-2.0 * ax, fast);
+        y = NAME(select)(ax < 1.0, -u / (u + 2.0), 1.0 - 2.0 / (t + 2.0));
+    } else {
+        z = ax * ax;
+        h = NAME(exp_dd)(2.0 * NAME(select)(ax < 22.0, ax,
+                                            NAME(splat)(22.0)), &l);
+        d = h + 1.0;
+        l += (h - d) + 1.0;
+        q = NAME(quotient)(2.0, d, l, &tail);
+        s = 1.0 - q;
+        y = NAME(select)(ax < 0.125,
+                         ax + ax * z * NAME(horner)(z, tanh_coefficients, 9),
+                         s + (((1.0 - s) - q) - tail));
+    }
+    y = NAME(select)(ax < 22.0, y, NAME(splat)(1.0));
+    y = NAME(select)((x == x) & (x != 0.0), y, x);
+    return NAME(negate)(negative, y);
+}
+
+INLINE V NAME(sqrt_v)(V x, int fast) {
+    (void)fast;
+    return VMATH_SQRT(x);
+}
+
+INLINE V NAME(log2_v)(V x, int fast) {
+    return NAME(log_scaled)(x, fast, 1.0, 0.0, IVLN2HI, IVLN2LO);
+}
+
+INLINE V NAME(log10_v)(V x, int fast) {
+    return NAME(log_scaled)(x, fast,
+                            LOG10_2HI, LOG10_2LO, IVLN10HI, IVLN10LO);
+}
+
+INLINE V NAME(pow_v)(V x, V y, int fast) {
+    V ay = NAME(select)(y < 0.0, -y, y);
+    VI bad = ~((x > 0.0) & (x < INFINITY) & (ay < 0x1p900));
+    V safe = NAME(select)(bad, NAME(splat)(1.0), x);
+    V h, lo, p, q, z;
+    if (fast) {
+        z = NAME(exp_v)(y * NAME(log_v)(safe, 0), 1);
+    } else {
+        h = NAME(log_dd)(safe, &lo);
+        p = y * h;
+        q = NAME(two_product)(y, h, p) + y * lo;
+        p = NAME(select)(p > 710.0, NAME(splat)(710.0), p);
+        p = NAME(select)(p < -746.0, NAME(splat)(-746.0), p);
+        z = NAME(exp_accurate)(p, q, 0.0);
+    }
+    for (int i = 0; i < VMATH_WIDTH; ++i) {
+        if (bad[i]) {
+            z[i] = pow(x[i], y[i]);
+        }
+    }
+    return z;
+}
+
+#define UNARY_KERNEL(name, kernel, fast) \
+    static void NAME(name)(const double *x, double *y, size_t n) { \
+        V v; \
+        double tail[VMATH_WIDTH]; \
+        size_t i = 0; \
+        for (; i + VMATH_WIDTH <= n; i += VMATH_WIDTH) { \
+            memcpy(&v, x + i, sizeof(V)); \
+            v = NAME(kernel)(v, fast); \
+            memcpy(y + i, &v, sizeof(V)); \
+        } \
+        if (i < n) { \
+            for (int j = 0; j < VMATH_WIDTH; ++j) { \
+                tail[j] = i + j < n ? x[i + j] : 1.0; \
+            } \
+            memcpy(&v, tail, sizeof(V)); \
+            v = NAME(kernel)(v, fast); \
+            memcpy(tail, &v, sizeof(V)); \
+            memcpy(y + i, tail, (n - i) * sizeof(double)); \
+        } \
+    }
+
+#define POW_KERNEL(name, fast) \
+    static void NAME(name)(const double *x, \
+                           const double *y, \
+                           double *z, \
+                           size_t n) { \
+        V u, v; \
+        double a[VMATH_WIDTH], b[VMATH_WIDTH]; \
+        size_t i = 0; \
+        for (; i + VMATH_WIDTH <= n; i += VMATH_WIDTH) { \
+            memcpy(&u, x + i, sizeof(V)); \
+            memcpy(&v, y + i, sizeof(V)); \
+            u = NAME(pow_v)(u, v, fast); \
+            memcpy(z + i, &u, sizeof(V)); \
+        } \
+        if (i < n) { \
+            for (int j = 0; j < VMATH_WIDTH; ++j) { \
+                a[j] = i + j < n ? x[i + j] : 1.0; \
+                b[j] = i + j < n ? y[i + j] : 1.0; \
+            } \
+            memcpy(&u, a, sizeof(V)); \
+            memcpy(&v, b, sizeof(V)); \
+            u = NAME(pow_v)(u, v, fast); \
+            memcpy(a, &u, sizeof(V)); \
+            memcpy(z + i, a, (n - i) * sizeof(double)); \
+        } \
+    }
+
+#define TIER_KERNELS(tier, fast) \
+    UNARY_KERNEL(CAT(sqrt, tier), sqrt_v, fast) \
+    UNARY_KERNEL(CAT(exp, tier), exp_v, fast) \
+    UNARY_KERNEL(CAT(exp2, tier), exp2_v, fast) \
+    UNARY_KERNEL(CAT(log, tier), log_v, fast) \
+    UNARY_KERNEL(CAT(log10, tier), log10_v, fast) \
+    UNARY_KERNEL(CAT(log2, tier), log2_v, fast) \
+    UNARY_KERNEL(CAT(sin, tier), sin_v, fast) \
+    UNARY_KERNEL(CAT(cos, tier), cos_v, fast) \
+    UNARY_KERNEL(CAT(tan, tier), tan_v, fast) \
+    UNARY_KERNEL(CAT(sinh, tier), sinh_v, fast) \
+    UNARY_KERNEL(CAT(cosh, tier), cosh_v, fast) \
+    UNARY_KERNEL(CAT(tanh, tier), tanh_v, fast) \
+    POW_KERNEL(CAT(pow, tier), fast)
+
+TIER_KERNELS(ulp, 0)
+TIER_KERNELS(fast, 1)
+
+#ifdef VMATH_SCALAR
+#define SCALAR_KERNEL(name, kernel, fast) \
+    static double NAME(name)(double x) { \
+        return NAME(kernel)(NAME(splat)(x), fast)[0]; \
+    }
+
+#define SCALAR_KERNELS(tier, fast) \
+    SCALAR_KERNEL(CAT(sqrt_scalar, tier), sqrt_v, fast) \
+    SCALAR_KERNEL(CAT(exp_scalar, tier), exp_v, fast) \
+    SCALAR_KERNEL(CAT(exp2_scalar, tier), exp2_v, fast) \
+    SCALAR_KERNEL(CAT(log_scalar, tier), log_v, fast) \
+    SCALAR_KERNEL(CAT(log10_scalar, tier), log10_v, fast) \
+    SCALAR_KERNEL(CAT(log2_scalar, tier), log2_v, fast) \
+    SCALAR_KERNEL(CAT(sin_scalar, tier), sin_v, fast) \
+    SCALAR_KERNEL(CAT(cos_scalar, tier), cos_v, fast) \
+    SCALAR_KERNEL(CAT(tan_scalar, tier), tan_v, fast) \
+    SCALAR_KERNEL(CAT(sinh_scalar, tier), sinh_v, fast) \
+    SCALAR_KERNEL(CAT(cosh_scalar, tier), cosh_v, fast) \
+    SCALAR_KERNEL(CAT(tanh_scalar, tier), tanh_v, fast) \
+    static double NAME(CAT(pow_scalar, tier))(double x, double y) { \
+        return NAME(pow_v)(NAME(splat)(x), NAME(splat)(y), fast)[0]; \
+    }
+
+SCALAR_KERNELS(ulp, 0)
+SCALAR_KERNELS(fast, 1)
+
+#undef SCALAR_KERNELS
+#undef SCALAR_KERNEL
+#endif
+
+#define TIER_TABLE(tier) { \
+        NAME(CAT(sqrt, tier)), \
+        NAME(CAT(exp, tier)), \
+        NAME(CAT(exp2, tier)), \
+        NAME(CAT(log, tier)), \
+        NAME(CAT(log10, tier)), \
+        NAME(CAT(log2, tier)), \
+        NAME(CAT(sin, tier)), \
+        NAME(CAT(cos, tier)), \
+        NAME(CAT(tan, tier)), \
+        NAME(CAT(sinh, tier)), \
+        NAME(CAT(cosh, tier)), \
+        NAME(CAT(tanh, tier)) \
+    }
+
+static const VectorUnary NAME(unary)[2][12] = {
+    TIER_TABLE(ulp),
+    TIER_TABLE(fast)
+};
+
+static const VectorBinary NAME(pow)[2] = {
+    NAME(pow_ulp),
+    NAME(pow_fast)
+};
+
+#ifdef VMATH_SCALAR
+static double (*const NAME(scalar)[2][12])(double) = {
+    TIER_TABLE(scalar_ulp),
+    TIER_TABLE(scalar_fast)
+};
+
+static double (*const NAME(scalar_pow)[2])(double, double) = {
+    NAME(pow_scalar_ulp),
+    NAME(pow_scalar_fast)
+};
+#endif
+
+#undef TIER_TABLE
+#undef TIER_KERNELS
+#undef POW_KERNEL
+#undef UNARY_KERNEL
+#undef INLINE
+#undef VU
+#undef VI
+#undef V
+#undef NAME
+#undef CAT
+#undef CAT_
@@ -0,0 +1,572 @@
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include "vmath.h"
+
+#pragma GCC optimize("fp-contract=off")
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#define MAGIC 0x1.8p52
+#define SPLITTER 134217729.0
+#define EXP_ULP 13
+#define EXP_FAST 10
+#define LOG2E 1.44269504088896338700e+00
+#define LN2 6.93147180559945286227e-01
+#define LN2HI 6.93147180369123816490e-01
+#define LN2LO 1.90821492927058770002e-10
+#define IVLN2HI 1.44269504072144627571e+00
+#define IVLN2LO 1.67517131648865118353e-10
+#define IVLN10HI 4.34294481878168880939e-01
+#define IVLN10LO 2.50829467116452752298e-11
+#define LOG10_2HI 3.01029995663611771306e-01
+#define LOG10_2LO 3.69423907715893078616e-13
+#define LG1 6.666666666666735130e-01
+#define LG2 3.999999999940941908e-01
+#define LG3 2.857142874366239149e-01
+#define LG4 2.222219843214978396e-01
+#define LG5 1.818357216161805012e-01
+#define LG6 1.531383769920937332e-01
+#define LG7 1.479819860511658591e-01
+#define S1 -1.66666666666666324348e-01
+#define S2 8.33333333332248946124e-03
+#define S3 -1.98412698298579493134e-04
+#define S4 2.75573137070700676789e-06
+#define S5 -2.50507602534068634195e-08
+#define S6 1.58969099521155010221e-10
+#define C1 4.16666666666666019037e-02
+#define C2 -1.38888888888741095749e-03
+#define C3 2.48015872894767294178e-05
+#define C4 -2.75573143513906633035e-07
+#define C5 2.08757232129817482790e-09
+#define C6 -1.13596475577881948265e-11
+#define INVPIO2 6.36619772367581382433e-01
+#define PIO2_1 1.57079632673412561417e+00
+#define PIO2_1T 6.07710050650619224932e-11
+#define PIO2_2 6.07710050630396597660e-11
+#define PIO2_3 2.02226624879595063154e-21
+#define TRIG_LIMIT 0x1p20
+#define LN2_TAIL 2.3190468138462996e-17
+#define PIO4 7.85398163397448278999e-01
+#define PIO4LO 3.06161699786838301793e-17
+#define TAN_REFLECT 0.6743354797363281
+
+static const double expm1_coefficients[EXP_ULP - 1] = {
+    0.5,
+    0.16666666666666666,
+    0.041666666666666664,
+    0.008333333333333333,
+    0.001388888888888889,
+    0.0001984126984126984,
+    2.48015873015873e-05,
+    2.7557319223985893e-06,
+    2.755731922398589e-07,
+    2.505210838544172e-08,
+    2.08767569878681e-09,
+    1.6059043836821613e-10
+};
+
+static const double exp2_coefficients[EXP_ULP] = {
+    0.6931471805599453,
+    0.24022650695910072,
+    0.05550410866482158,
+    0.009618129107628477,
+    0.0013333558146428443,
+    0.0001540353039338161,
+    1.5252733804059841e-05,
+    1.321548679014431e-06,
+    1.01780860092397e-07,
+    7.054911620801123e-09,
+    4.4455382718708116e-10,
+    2.5678435993488206e-11,
+    1.3691488853904128e-12
+};
+
+static const double log1p_coefficients[7] = {
+    -0.5,
+    0.3333333333333333,
+    -0.25,
+    0.2,
+    -0.16666666666666666,
+    0.14285714285714285,
+    -0.125
+};
+
+static const double sinh_coefficients[9] = {
+    0.16666666666666666,
+    0.008333333333333333,
+    0.0001984126984126984,
+    2.7557319223985893e-06,
+    2.505210838544172e-08,
+    1.6059043836821613e-10,
+    7.647163731819816e-13,
+    2.8114572543455206e-15,
+    8.22063524662433e-18
+};
+
+static const double tanh_coefficients[9] = {
+    -0.3333333333333333,
+    0.13333333333333333,
+    -0.05396825396825397,
+    0.021869488536155203,
+    -0.008863235529902197,
+    0.003592128036572481,
+    -0.0014558343870513183,
+    0.000590027440945586,
+    -0.00023912911424355248
+};
+
+static const double tan_coefficients[13] = {
+    3.33333333333334091986e-01,
+    1.33333333333201242699e-01,
+    5.39682539762260521377e-02,
+    2.18694882948595424599e-02,
+    8.86323982359930005737e-03,
+    3.59207910759131235356e-03,
+    1.45620945432529025516e-03,
+    5.88041240820264096874e-04,
+    2.46463134818469906812e-04,
+    7.81794442939557092300e-05,
+    7.14072491382608190305e-05,
+    -1.85586374855275456654e-05,
+    2.59073051863633712884e-05
+};
+
+/* 2^(i / 128) as hi + lo. */
+static const double exp_table[128][2] = {
+    { 1.0, 0.0 },
+    { 1.0054299011128027, 9.499186535455032e-17 },
+    { 1.0108892860517005, -1.5234778603368577e-17 },
+    { 1.016378314910953, -5.77217007319966e-17 },
+    { 1.0218971486541166, 5.109225028973444e-17 },
+    { 1.0274459491187637, -4.9560741746453704e-17 },
+    { 1.0330248790212284, 7.600838874027088e-18 },
+    { 1.0386341019613787, 5.996273788852511e-17 },
+    { 1.0442737824274138, 8.551889705537965e-17 },
+    { 1.0499440858006872, 5.592937848127003e-17 },
+    { 1.0556451783605572, 1.759325738772092e-18 },
+    { 1.061377227289262, -1.1973537085365658e-17 },
+    { 1.0671404006768237, -7.899853966841582e-17 },
+    { 1.0729348675259756, -3.839668843358824e-18 },
+    { 1.0787607977571199, -6.656660436056593e-17 },
+    { 1.0846183622133092, 3.166152845816346e-17 },
+    { 1.0905077326652577, -3.046782079812471e-17 },
+    { 1.0964290818163769, -5.919933484449316e-17 },
+    { 1.102382583307841, 5.2660368715706944e-17 },
+    { 1.1083684117236787, -8.786813845180527e-17 },
+    { 1.1143867425958924, 1.0410278456845571e-16 },
+    { 1.1204377524096067, -6.201085906554179e-17 },
+    { 1.1265216186082418, 5.165856758795457e-17 },
+    { 1.1326385195987192, 3.237356166738e-17 },
+    { 1.1387886347566916, 8.912812676025408e-17 },
+    { 1.1449721444318042, 4.6412898921700107e-17 },
+    { 1.1511892299529827, 3.250710218863827e-17 },
+    { 1.1574400736337511, -9.1238712311344e-17 },
+    { 1.1637248587775775, 3.8292048369240935e-17 },
+    { 1.1700437696832502, -1.8477442017900047e-18 },
+    { 1.1763969916502812, 5.554203254218079e-17 },
+    { 1.182784710984341, 1.542975430079076e-17 },
+    { 1.189207115002721, 3.982015231465646e-17 },
+    { 1.1956643920398273, 4.6166036704814814e-17 },
+    { 1.202156731452703, 6.644981499252301e-17 },
+    { 1.2086843236265816, -4.746725945228984e-17 },
+    { 1.215247359980469, -7.712630692681488e-17 },
+    { 1.2218460329727576, -1.0611021211402691e-16 },
+    { 1.22848053610687, -1.89878163130253e-17 },
+    { 1.2351510639369334, -1.0755244344307841e-16 },
+    { 1.241857812073484, 4.658027591836937e-17 },
+    { 1.2486009771892048, -8.261810999021964e-17 },
+    { 1.255380757024691, -6.7113898212968784e-18 },
+    { 1.2621973503942507, -3.0844648874738465e-17 },
+    { 1.2690509571917332, 2.667932131342186e-18 },
+    { 1.275941778396392, 9.91543024421429e-17 },
+    { 1.2828700160787783, 1.713594918243561e-17 },
+    { 1.2898358734066657, 8.949257530897592e-17 },
+    { 1.2968395546510096, 2.5382502794888315e-17 },
+    { 1.3038812651919358, 8.647675598267871e-17 },
+    { 1.3109612115247644, -7.181536135519454e-17 },
+    { 1.318079601266064, -5.4579558271491535e-17 },
+    { 1.3252366431597413, -2.8587312100388614e-17 },
+    { 1.3324325470831615, -5.101586630916744e-17 },
+    { 1.339667524053303, 8.927282594831732e-17 },
+    { 1.3469417862329458, 3.224065101254679e-17 },
+    { 1.3542555469368927, 7.70094837980299e-17 },
+    { 1.3616090206382248, 1.533787661270668e-18 },
+    { 1.3690024229745905, 9.593797919118849e-17 },
+    { 1.3764359707545302, -6.898588935871801e-17 },
+    { 1.383909881963832, -6.770511658794786e-17 },
+    { 1.3914243757719262, -4.9061748652889893e-17 },
+    { 1.3989796725383112, -9.614213209051323e-17 },
+    { 1.4065759938190154, 7.034914812136422e-18 },
+    { 1.4142135623730951, -9.667293313452913e-17 },
+    { 1.4218926021691656, -1.6077828915890244e-17 },
+    { 1.42961333839197, -1.2031642489053655e-17 },
+    { 1.4373759974489824, -4.2040340164675566e-17 },
+    { 1.4451808069770467, -3.0237581349939873e-17 },
+    { 1.4530279958490526, -5.779948609396106e-17 },
+    { 1.460917794180647, -5.600377186075216e-17 },
+    { 1.4688504333369818, 8.465882756533628e-17 },
+    { 1.4768261459394993, -3.483994556892796e-17 },
+    { 1.4848451658727524, 1.0780086764407481e-16 },
+    { 1.4929077282912648, 1.4192920154284036e-17 },
+    { 1.5010140696264256, -6.413767275790235e-17 },
+    { 1.5091644275934228, -1.016455327754295e-16 },
+    { 1.5173590411982147, -4.308699472043341e-17 },
+    { 1.5255981507445384, -1.1024941712342561e-16 },
+    { 1.533881997840956, 8.875226844438446e-17 },
+    { 1.5422108254079407, 7.949834809697621e-17 },
+    { 1.550584877685, -1.4600706590689385e-17 },
+    { 1.559004400237837, 3.7812070533575275e-17 },
+    { 1.567469639965553, -1.0352061768849722e-16 },
+    { 1.5759808451078865, -1.0136916471278304e-17 },
+    { 1.5845382652524937, -1.9337717034585703e-17 },
+    { 1.593142151342267, -1.0094406542311964e-16 },
+    { 1.6017927556826934, -6.054917453527784e-17 },
+    { 1.6104903319492543, 2.4707192569797888e-17 },
+    { 1.6192351351948637, 2.0941334154229092e-17 },
+    { 1.6280274218573478, -6.712955084707084e-17 },
+    { 1.6368674497669644, 7.698325071319876e-17 },
+    { 1.645755478153965, -1.0125679913674773e-16 },
+    { 1.6546917676561943, 9.643294303196029e-17 },
+    { 1.6636765803267364, 5.8909926967131e-17 },
+    { 1.6727101796415966, -5.476715964599563e-17 },
+    { 1.681792830507429, 8.199010020581497e-17 },
+    { 1.6909247992693053, -9.66967147439488e-17 },
+    { 1.7001063537185235, -8.0237193703977e-18 },
+    { 1.709337763100463, -9.868779456632931e-17 },
+    { 1.718619298122478, -1.851380418263111e-17 },
+    { 1.7279512309618377, -1.0750981861204642e-16 },
+    { 1.7373338352737062, 3.164389299292957e-17 },
+    { 1.746767386199169, -1.0752290483507515e-16 },
+    { 1.7562521603732995, 2.960140695448873e-17 },
+    { 1.7657884359332727, 9.461315018083268e-17 },
+    { 1.7753764925265212, 6.429731796556572e-17 },
+    { 1.785016611318935, 1.5330400121031314e-17 },
+    { 1.7947090750031072, 1.8227458427912087e-17 },
+    { 1.804454167806624, -5.177222408793318e-17 },
+    { 1.8142521755003989, -9.969531538920349e-17 },
+    { 1.8241033854070534, -1.0159627862277083e-16 },
+    { 1.8340080864093424, 3.283107224245627e-17 },
+    { 1.843966568958626, -5.939742026949965e-17 },
+    { 1.8539791250833855, 9.761887490727594e-17 },
+    { 1.864046048397789, 6.540912680620572e-17 },
+    { 1.8741676341103, -6.122763413004143e-17 },
+    { 1.8843441790323345, -8.226593125533711e-17 },
+    { 1.8945759815869656, 3.4034035352165297e-17 },
+    { 1.9048633418176741, 6.533857514718279e-17 },
+    { 1.9152065613971474, -1.0619946056195963e-16 },
+    { 1.925605943636125, -9.914963769693741e-17 },
+    { 1.9360617934922943, 1.0332385960676326e-16 },
+    { 1.9465744175792332, 6.811022349533877e-17 },
+    { 1.9571441241754002, 8.960767791036668e-17 },
+    { 1.9677712232331759, -1.0314928011531132e-16 },
+    { 1.978456026387951, 4.0388753109278167e-17 },
+    { 1.9891988469672663, 8.2051326383692e-18 }
+};
+
+/* 1 / c and -log(1 / c) as hi + lo for c = 1 + (i + 0.5) / 128. */
+static const double log_table[128][3] = {
+    { 0.9961089494163424, 0.003898640415657309, 1.2541659038304982e-19 },
+    { 0.9884169884169884, 0.01165061721997525, 6.311738528333134e-19 },
+    { 0.9808429118773946, 0.019342962843130987, -6.612867620320467e-19 },
+    { 0.973384030418251, 0.026976587698202083, -1.357561021795712e-18 },
+    { 0.9660377358490566, 0.03455238150665973, -2.5264681161162764e-18 },
+    { 0.9588014981273408, 0.042071213920687044, -9.713775354759503e-20 },
+    { 0.9516728624535316, 0.049533935122276676, 1.664443731663614e-18 },
+    { 0.9446494464944649, 0.05694137640013845, 1.78594464879227e-18 },
+    { 0.9377289377289377, 0.06429435070539725, 3.475225966814173e-18 },
+    { 0.9309090909090909, 0.07159365318700882, 4.869195800165027e-19 },
+    { 0.924187725631769, 0.078840061707776, -4.568340554252506e-18 },
+    { 0.9175627240143369, 0.08603433734180316, -3.36803314523905e-18 },
+    { 0.9110320284697508, 0.09317722485418334, 2.8334317358750366e-18 },
+    { 0.9045936395759717, 0.10026945316367517, -2.822998867357873e-18 },
+    { 0.8982456140350877, 0.10731173578908804, -4.322456718254657e-18 },
+    { 0.89198606271777, 0.11430477128005863, 5.977397630760421e-18 },
+    { 0.8858131487889274, 0.12124924363286965, 2.6827199737801766e-18 },
+    { 0.8797250859106529, 0.12814582269193006, -4.109471350011548e-18 },
+    { 0.8737201365187713, 0.13499516453750482, 1.369660501724148e-18 },
+    { 0.8677966101694915, 0.1417979118602574, -1.2867304346273362e-17 },
+    { 0.8619528619528619, 0.1485546943231372, -1.1863378834702217e-17 },
+    { 0.8561872909698997, 0.15526612891112396, 1.1990886572394084e-17 },
+    { 0.8504983388704319, 0.16193282026931324, -1.3644842250457798e-17 },
+    { 0.8448844884488449, 0.16855536102980664, 1.0763132959988806e-17 },
+    { 0.839344262295082, 0.17513433212784915, -2.724105290158387e-18 },
+    { 0.8338762214983714, 0.18167030310763463, 4.954929708083542e-18 },
+    { 0.8284789644012945, 0.18816383241818294, 3.741953239550891e-18 },
+    { 0.8231511254019293, 0.19461546769967167, 1.9890959474466474e-18 },
+    { 0.8178913738019169, 0.2010257460605908, -4.5707808879306246e-18 },
+    { 0.8126984126984127, 0.2073951943460706, -5.756619770435678e-18 },
+    { 0.807570977917981, 0.21372432939771818, -1.2735141289933245e-17 },
+    { 0.8025078369905956, 0.22001365830528213, 1.1961281714072477e-18 },
+    { 0.7975077881619937, 0.2262636786504534, 8.337560297889984e-18 },
+    { 0.7925696594427245, 0.232474878743094, 6.160927890733764e-18 },
+    { 0.7876923076923077, 0.238647737850175, -1.6128470577184094e-18 },
+    { 0.7828746177370031, 0.24478272641769092, -7.47089098380464e-18 },
+    { 0.7781155015197568, 0.25088030628580943, -8.553911523038828e-18 },
+    { 0.7734138972809668, 0.2569409308975004, 7.175242481751694e-18 },
+    { 0.7687687687687688, 0.26296504550088134, 1.5718867588147142e-17 },
+    { 0.764179104477612, 0.26895308734550394, 1.0592604897911732e-17 },
+    { 0.7596439169139466, 0.2749054858727992, -1.402747850115579e-17 },
+    { 0.7551622418879056, 0.2808226629008878, -1.0950013154836128e-17 },
+    { 0.750733137829912, 0.2867050328039543, -2.8116608187823606e-18 },
+    { 0.7463556851311953, 0.29255300268637746, -5.2811179490291116e-18 },
+    { 0.7420289855072464, 0.2983669725517973, -1.3287151317641232e-17 },
+    { 0.7377521613832853, 0.3041473354672968, 7.010822479304778e-18 },
+    { 0.7335243553008596, 0.3098944777228647, 4.5997359765827076e-18 },
+    { 0.7293447293447294, 0.3156087789863033, -1.0493698520483516e-17 },
+    { 0.7252124645892352, 0.32129061245373425, -3.035364123413162e-18 },
+    { 0.7211267605633803, 0.3269403449958533, -1.5322929902901654e-17 },
+    { 0.7170868347338936, 0.3325583373000766, -1.8692002087134156e-17 },
+    { 0.713091922005571, 0.3381449440087164, -2.4651351958263637e-17 },
+    { 0.7091412742382271, 0.34370051385331846, -1.421331198699375e-17 },
+    { 0.7052341597796143, 0.3492253897852883, 4.02376954597919e-19 },
+    { 0.7013698630136986, 0.354719909102929, 2.198105025613807e-17 },
+    { 0.6975476839237057, 0.3601844035750078, 2.6812351028097144e-17 },
+    { 0.6937669376693767, 0.3656191995609647, -1.2762016415473489e-17 },
+    { 0.6900269541778976, 0.37102461812787263, -1.948933773396101e-17 },
+    { 0.6863270777479893, 0.376400975164253, 2.032121209009643e-17 },
+    { 0.6826666666666666, 0.3817485814908484, -1.9951991043846497e-17 },
+    { 0.6790450928381963, 0.3870677429684483, 2.5550894542318646e-17 },
+    { 0.6754617414248021, 0.3923587606028639, 9.493401229363408e-18 },
+    { 0.6719160104986877, 0.3976219306471385, -1.8770120125166398e-17 },
+    { 0.6684073107049608, 0.4028575447010835, 2.0735595335748982e-17 },
+    { 0.6649350649350649, 0.4080658898082217, 2.2555328171649924e-17 },
+    { 0.661498708010336, 0.41324724855021927, 1.83564053756299e-17 },
+    { 0.6580976863753213, 0.41840189913888387, 1.952505810230571e-17 },
+    { 0.6547314578005116, 0.4235301155058032, -3.671128446641214e-18 },
+    { 0.6513994910941476, 0.42863216738969867, 1.5023865716575906e-17 },
+    { 0.6481012658227848, 0.4337083204215594, -4.233377663176456e-18 },
+    { 0.6448362720403022, 0.43875883620762796, 8.850494198594658e-18 },
+    { 0.6416040100250626, 0.44378397241030104, -5.239134183313927e-18 },
+    { 0.6384039900249376, 0.4487839828270067, 2.4596939449035226e-17 },
+    { 0.6352357320099256, 0.4537591174671205, 8.966360351297184e-18 },
+    { 0.6320987654320988, 0.4587096226269767, 8.89739309588395e-18 },
+    { 0.628992628992629, 0.46363574096303256, -2.318971916386853e-17 },
+    { 0.6259168704156479, 0.46853771156323926, 1.831649987461153e-17 },
+    { 0.6228710462287105, 0.4734157700166721, -1.6738097350855667e-17 },
+    { 0.6198547215496368, 0.47827014848147026, -2.5927046143170282e-17 },
+    { 0.6168674698795181, 0.48310107575113576, -2.0919266382100576e-17 },
+    { 0.6139088729016786, 0.48790877731923904, 1.9519380098629437e-18 },
+    { 0.6109785202863962, 0.4926934754425752, 1.9165580353815043e-17 },
+    { 0.6080760095011877, 0.4974553892028189, -3.710716409978127e-19 },
+    { 0.6052009456264775, 0.5021947345667155, 3.472303869689812e-17 },
+    { 0.6023529411764705, 0.5069117244448544, 2.674457896979575e-18 },
+    { 0.5995316159250585, 0.5116065687490621, 5.4665154936605785e-18 },
+    { 0.5967365967365967, 0.5162794744484545, 4.080333547829478e-17 },
+    { 0.5939675174013921, 0.5209306456241853, 1.4017426376082978e-17 },
+    { 0.5912240184757506, 0.5255602835229274, 2.392692027506939e-18 },
+    { 0.5885057471264368, 0.5301685866091216, 4.7977752241645524e-17 },
+    { 0.585812356979405, 0.5347557506160276, 2.5827931609964474e-17 },
+    { 0.5831435079726651, 0.5393219685956089, 4.145643183164215e-17 },
+    { 0.5804988662131519, 0.5438674309672835, -2.4887893733251422e-17 },
+    { 0.5778781038374717, 0.5483923255655733, -2.2248947680151258e-17 },
+    { 0.5752808988764045, 0.5528968376866776, 1.6015836075564846e-17 },
+    { 0.5727069351230425, 0.5573811501340064, 2.5286768548149667e-17 },
+    { 0.5701559020044543, 0.5618454432626918, 4.9026031959620214e-17 },
+    { 0.5676274944567627, 0.5662898950231159, -1.2205644089016799e-17 },
+    { 0.565121412803532, 0.5707146810034716, -1.2108711910296867e-17 },
+    { 0.5626373626373626, 0.575119974471388, -2.1177801889528357e-17 },
+    { 0.5601750547045952, 0.5795059464146423, 1.3052678089315004e-18 },
+    { 0.5577342047930284, 0.5838727655809826, 2.6753352477773804e-17 },
+    { 0.5553145336225597, 0.588220598517086, 4.455131814161311e-17 },
+    { 0.5529157667386609, 0.5925496096066716, -4.139441474530835e-17 },
+    { 0.5505376344086022, 0.5968599611077938, 1.361230242186179e-17 },
+    { 0.5481798715203426, 0.6011518131893347, 3.083693330781544e-17 },
+    { 0.5458422174840085, 0.6054253239667169, 2.0084268288713302e-17 },
+    { 0.5435244161358811, 0.6096806495368553, -1.0121969910957006e-17 },
+    { 0.5412262156448203, 0.6139179440123704, 1.891277770208659e-17 },
+    { 0.5389473684210526, 0.6181373595550788, -1.653589827962475e-18 },
+    { 0.5366876310272537, 0.6223390464087787, 3.404611643248449e-18 },
+    { 0.534446764091858, 0.6265231529313529, 3.737570852476905e-18 },
+    { 0.5322245322245323, 0.6306898256261987, -3.613150752645848e-17 },
+    { 0.5300207039337475, 0.6348392091730102, -3.7188914839393193e-17 },
+    { 0.5278350515463918, 0.6389714464579207, -1.4406044597193659e-18 },
+    { 0.5256673511293635, 0.6430866786030273, 1.6159833988512732e-17 },
+    { 0.523517382413088, 0.6471850449953095, -3.2577745344279955e-17 },
+    { 0.5213849287169042, 0.6512666833149582, 1.3967924159705533e-17 },
+    { 0.5192697768762677, 0.6553317295631277, -3.911705867306146e-17 },
+    { 0.5171717171717172, 0.6593803180891278, 4.5449277548859387e-17 },
+    { 0.5150905432595574, 0.6634125816170662, -1.0168075202042099e-17 },
+    { 0.5130260521042084, 0.6674286512719563, -1.9461688656926497e-18 },
+    { 0.5109780439121756, 0.6714286566053024, 3.1081179603786107e-17 },
+    { 0.5089463220675944, 0.6754127256201768, -1.2023263005697002e-17 },
+    { 0.5069306930693069, 0.6793809847957973, -1.2107088539268054e-20 },
+    { 0.504930966469428, 0.6833335591116206, 1.8406949760527185e-18 },
+    { 0.5029469548133595, 0.6872705720709603, 2.184185453023377e-17 },
+    { 0.5009784735812133, 0.691192145724142, 1.0222351066223756e-17 }
+};
+
+#if defined(__x86_64__)
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#define VMATH_ISA avx512
+#define VMATH_WIDTH 8
+#define VMATH_SQRT(x) ((vd_avx512)_mm512_sqrt_pd((__m512d)(x)))
+#define VMATH_FMA(a, b, c) \
+    ((vd_avx512)_mm512_fmadd_pd((__m512d)(a), (__m512d)(b), (__m512d)(c)))
+#include "kernels.h"
+#undef VMATH_FMA
+#undef VMATH_SQRT
+#undef VMATH_WIDTH
+#undef VMATH_ISA
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#define VMATH_ISA avx2
+#define VMATH_WIDTH 4
+#define VMATH_SQRT(x) ((vd_avx2)_mm256_sqrt_pd((__m256d)(x)))
+#define VMATH_FMA(a, b, c) \
+    ((vd_avx2)_mm256_fmadd_pd((__m256d)(a), (__m256d)(b), (__m256d)(c)))
+#include "kernels.h"
+#undef VMATH_FMA
+#undef VMATH_SQRT
+#undef VMATH_WIDTH
+#undef VMATH_ISA
+#pragma GCC pop_options
+
+/*
+ * Rounding is identical on every instruction set, with contraction off and
+ * two_product exact either way, so the narrowest instance also serves the
+ * scalar calls and matches the batch results bit for bit.
+ */
+#define VMATH_SCALAR
+#define VMATH_ISA sse2
+#define VMATH_WIDTH 2
+#define VMATH_SQRT(x) ((vd_sse2)_mm_sqrt_pd((__m128d)(x)))
+#include "kernels.h"
+#undef VMATH_SQRT
+#undef VMATH_WIDTH
+#undef VMATH_ISA
+
+#undef VMATH_SCALAR
+#define NARROW_SCALAR scalar_sse2
+#define NARROW_SCALAR_POW scalar_pow_sse2
+
+#else
+
+#define VMATH_SCALAR
+#define VMATH_ISA generic
+#define VMATH_WIDTH 2
+#define VMATH_SQRT(x) ((vd_generic){ sqrt((x)[0]), sqrt((x)[1]) })
+#include "kernels.h"
+#undef VMATH_SQRT
+#undef VMATH_WIDTH
+#undef VMATH_ISA
+
+#undef VMATH_SCALAR
+#define NARROW_SCALAR scalar_generic
+#define NARROW_SCALAR_POW scalar_pow_generic
+
+#endif
+
+#define STRICT(name) \
+    static void strict_##name(const double *x, double *y, size_t n) { \
+        for (size_t i = 0; i < n; ++i) { \
+            y[i] = name(x[i]); \
+        } \
+    }
+
+STRICT(sqrt)
+STRICT(exp)
+STRICT(exp2)
+STRICT(log)
+STRICT(log10)
+STRICT(log2)
+STRICT(sin)
+STRICT(cos)
+STRICT(tan)
+STRICT(sinh)
+STRICT(cosh)
+STRICT(tanh)
+
+static void strict_pow(const double *x, const double *y, double *z, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        z[i] = pow(x[i], y[i]);
+    }
+}
+
+VectorUnary vmath_unary[3][12] = {
+    {
+        strict_sqrt,
+        strict_exp,
+        strict_exp2,
+        strict_log,
+        strict_log10,
+        strict_log2,
+        strict_sin,
+        strict_cos,
+        strict_tan,
+        strict_sinh,
+        strict_cosh,
+        strict_tanh
+    }
+};
+
+VectorBinary vmath_pow[3] = {
+    strict_pow
+};
+
+double (*vmath_scalar[3][12])(double) = {
+    {
+        sqrt,
+        exp,
+        exp2,
+        log,
+        log10,
+        log2,
+        sin,
+        cos,
+        tan,
+        sinh,
+        cosh,
+        tanh
+    }
+};
+
+double (*vmath_scalar_pow[3])(double, double) = {
+    pow
+};
+
+const char *math_names[3] = {
+    "Strict",
+    "ULP",
+    "Fast"
+};
+
+const char *vmath_isa;
+
+static void use(const VectorUnary (*unary)[12],
+                const VectorBinary *binary,
+                const char *isa) {
+    memcpy(vmath_unary[MATH_ULP], unary[0], sizeof(vmath_unary[0]));
+    memcpy(vmath_unary[MATH_FAST], unary[1], sizeof(vmath_unary[0]));
+    vmath_pow[MATH_ULP] = binary[0];
+    vmath_pow[MATH_FAST] = binary[1];
+    vmath_isa = isa;
+}
+
+static void __attribute__((constructor)) vmath_initialize(void) {
+    memcpy(vmath_scalar[MATH_ULP], NARROW_SCALAR[0],
+           sizeof(vmath_scalar[0]));
+    memcpy(vmath_scalar[MATH_FAST], NARROW_SCALAR[1],
+           sizeof(vmath_scalar[0]));
+    vmath_scalar_pow[MATH_ULP] = NARROW_SCALAR_POW[0];
+    vmath_scalar_pow[MATH_FAST] = NARROW_SCALAR_POW[1];
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        use(unary_avx512, pow_avx512, "AVX-512");
+    } else if (__builtin_cpu_supports("avx2") &&
+               __builtin_cpu_supports("fma")) {
+        use(unary_avx2, pow_avx2, "AVX2");
+    } else {
+        use(unary_sse2, pow_sse2, "SSE2");
+    }
+#else
+    use(unary_generic, pow_generic, "generic");
+#endif
+}
@@ -0,0 +1,23 @@
+#ifndef _VMATH_H_
+#define _VMATH_H_
+
+#include <stddef.h>
+
+#define MATH_STRICT 0
+#define MATH_ULP 1
+#define MATH_FAST 2
+
+typedef void (*VectorUnary)(const double *x, double *y, size_t n);
+typedef void (*VectorBinary)(const double *x,
+                             const double *y,
+                             double *z,
+                             size_t n);
+
+extern VectorUnary vmath_unary[3][12];
+extern VectorBinary vmath_pow[3];
+extern double (*vmath_scalar[3][12])(double);
+extern double (*vmath_scalar_pow[3])(double, double);
+extern const char *math_names[3];
+extern const char *vmath_isa;
+
+#endif
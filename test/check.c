@@ -0,0 +1,454 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#include <sys/stat.h>
+#include "../src/core/core.h"
+#include "../src/cli/cli.h"
+#include "../src/solve/solve.h"
+#include "../src/vmath/vmath.h"
+#include "../src/precision/precision.h"
+
+#define POINTS 4096
+#define CACHE "test/cache"
+
+static const char *paths[] = {
+    "x sin x cos * x exp log + x sqrt x tanh * + x log2 x cosh / +",
+    "x 3 ^ 2 x 2 ^ * - x 5 * + 1 - x 2 ^ 1 + /",
+    "x 1 + x 2 + x 3 + x 4 + x 5 + x 6 + x 7 + x 8 + "
+    "x 9 + x 10 + x 11 + x 12 + x 13 + x 14 + x 15 + x 16 + "
+    "* / * / * / * / * / * / * / *",
+    "x sin x sin * x sin +",
+    "x 0 + 1 * 2 3 + * x exp /",
+    "x 2.5 ^ x -3 ^ + x 0.5 ^ -",
+    "x exp2 x log10 + x tan - x sinh +",
+    "pi x * sin x 1 + /",
+    "1 x /",
+    "x x /"
+};
+
+static const double specials[] = {
+    0, 1, -1, 0.5, 1e-300, 1e300, -1e300, INFINITY, -INFINITY, NAN
+};
+
+static struct Symbol symbols[100];
+static double xs[POINTS], ys[POINTS], zs[POINTS], refs[POINTS];
+static int checks, failures;
+
+static void expect(char ok, const char *format, ...) {
+    va_list args;
+    ++checks;
+    if (ok) {
+        return;
+    }
+    ++failures;
+    printf("FAIL ");
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+    printf("\n");
+}
+
+static char same(double a, double b) {
+    return !memcmp(&a, &b, sizeof(double)) || a == b ||
+           (isnan(a) && isnan(b));
+}
+
+static char close(double a, double b, double tolerance) {
+    if (isnan(b) || isinf(b)) {
+        return same(a, b);
+    }
+    return fabs(a - b) <= tolerance * fmax(1, fabs(b));
+}
+
+/* One check per column: got[i] against want[i], bit for bit if tolerance < 0 */
+static void compare(const char *text, const char *what, const double *got,
+                    const double *want, double tolerance) {
+    for (size_t i = 0; i < POINTS; ++i) {
+        if (tolerance < 0 ? !same(got[i], want[i]) :
+            !close(got[i], want[i], tolerance)) {
+            expect(0, "%s at %g: %s %.17g, expected %.17g",
+                   text, xs[i], what, got[i], want[i]);
+            return;
+        }
+    }
+    expect(1, "%s", what);
+}
+
+/* Evaluates the parsed symbols directly with libm, before any rewriting */
+static double reference(double x) {
+    double stack[100];
+    int depth = 0;
+    for (int i = 0; i < 100; ++i) {
+        switch (symbols[i].type) {
+        case NUMBER:
+            stack[depth++] = symbols[i].data.number;
+            break;
+        case INPUT:
+            stack[depth++] = x;
+            break;
+        case UNARY:
+            stack[depth - 1] = unary_lookup[(int)symbols[i].data.unary](
+                stack[depth - 1]
+            );
+            break;
+        case BINARY:
+            --depth;
+            stack[depth - 1] = binary_lookup[(int)symbols[i].data.binary](
+                stack[depth - 1], stack[depth]
+            );
+            break;
+        }
+    }
+    return stack[0];
+}
+
+static void inputs(double from, double to, char special) {
+    size_t n = special ? sizeof(specials) / sizeof(specials[0]) : 0;
+    for (size_t i = 0; i < POINTS; ++i) {
+        xs[i] = i < n ? specials[i] : from + (to - from) * i / POINTS;
+        refs[i] = reference(xs[i]);
+    }
+}
+
+static int load(struct Context *context, const char *text) {
+    core_context_initialize(context);
+    context->memo.limit = 0;
+    if (cli_parse(text, symbols)) {
+        return -1;
+    }
+    return core_context_compile(context, symbols);
+}
+
+/* Every strict double backend agrees with the VM bit for bit */
+static void check_paths(const char *text) {
+    struct Context vm, jit, verify, aot;
+    double y;
+    int ret;
+    expect(!load(&vm, text) && !load(&jit, text) && !load(&verify, text),
+           "compile %s", text);
+    inputs(-4, 4, 1);
+    vm.use_jit = 0;
+    core_context_compile(&vm, symbols);
+    verify.verify = 1;
+    for (size_t i = 0; i < POINTS; ++i) {
+        core_context_evaluate(&vm, xs[i], zs + i);
+    }
+    compare(text, "vm", zs, refs, 1e-13);
+    for (size_t i = 0; i < POINTS; ++i) {
+        core_context_evaluate(&jit, xs[i], ys + i);
+    }
+    compare(text, "jit", ys, zs, -1);
+    if (vm.polynomial.degree < 0) {
+        ret = core_context_evaluate_batch(&vm, xs, ys, POINTS);
+        expect(!ret, "%s columns error %d", text, ret);
+        compare(text, "columns", ys, zs, -1);
+        ret = core_context_evaluate_parallel(&jit, xs, ys, POINTS);
+        expect(!ret, "%s parallel error %d", text, ret);
+        compare(text, "parallel", ys, zs, -1);
+    }
+    ret = core_context_evaluate_batch(&verify, xs, ys, POINTS);
+    expect(!ret, "%s -t batch error %d", text, ret);
+    vm.use_optimizer = 0;
+    core_context_compile(&vm, symbols);
+    for (size_t i = 0; i < POINTS; ++i) {
+        core_context_evaluate(&vm, xs[i], ys + i);
+    }
+    compare(text, "unoptimized", ys, refs, -1);
+    if (!strcmp(text, paths[0])) {
+        load(&aot, text);
+        aot.use_aot = 1;
+        core_context_compile(&aot, symbols);
+        core_context_evaluate(&aot, 1, &y);
+        if (aot.aot.function) {
+            core_context_evaluate_batch(&aot, xs, ys, POINTS);
+            compare(text, "compiled", ys, zs, -1);
+        } else {
+            printf("skip -c: gcc not available\n");
+        }
+        core_context_finalize(&aot);
+    }
+    core_context_finalize(&vm);
+    core_context_finalize(&jit);
+    core_context_finalize(&verify);
+}
+
+/* Tiers and precisions stay close to libm, and scalar matches batch */
+static void check_tier(const char *text, int math, int precision,
+                       double tolerance) {
+    struct Context context;
+    char what[32];
+    load(&context, text);
+    inputs(0.25, 4, precision != PRECISION_FLOAT);
+    context.math = math;
+    context.precision = precision;
+    core_context_compile(&context, symbols);
+    expect(!core_context_evaluate_batch(&context, xs, ys, POINTS),
+           "%s tier %d precision %d batch", text, math, precision);
+    for (size_t i = 0; i < POINTS; ++i) {
+        core_context_evaluate(&context, xs[i], zs + i);
+    }
+    snprintf(what, sizeof(what), "tier %d precision %d", math, precision);
+    compare(text, what, ys, refs, tolerance);
+    compare(text, what, zs, ys, -1);
+    core_context_finalize(&context);
+}
+
+static void check_rewrites(void) {
+    struct Context context;
+    load(&context, "x 0 + 1 * 2 3 + * x exp /");
+    expect(context.program.removed > 0, "optimizer removed %d",
+           context.program.removed);
+    load(&context, "x sin x sin * x sin +");
+    expect(context.program.shared > 0, "cse shared %d",
+           context.program.shared);
+    core_context_finalize(&context);
+}
+
+static void check_memo(void) {
+    struct Context context;
+    load(&context, "x sin x exp *");
+    context.memo.limit = MEMO_LIMIT;
+    core_context_compile(&context, symbols);
+    inputs(-4, 4, 1);
+    core_context_evaluate_batch(&context, xs, ys, POINTS);
+    core_context_evaluate_batch(&context, xs, zs, POINTS);
+    expect(context.memo.hits >= POINTS, "memo hits %llu",
+           context.memo.hits);
+    compare("x sin x exp *", "memo", ys, refs, -1);
+    compare("x sin x exp *", "memo hit", zs, ys, -1);
+    core_context_finalize(&context);
+}
+
+static void check_integrals(void) {
+    static const double tolerances[8] = {
+        1e-5, 1e-10, 1e-10, 1e-10, 1e-10, 1e-10, 1e-10, 1e-10
+    };
+    struct Context context;
+    double result, error;
+    load(&context, "x sin");
+    for (int rule = RULE_TRAPEZOID; rule <= RULE_ADAPTIVE; ++rule) {
+        context.rule = rule;
+        expect(!core_context_integrate(&context, 0, pi, 1000, &result) &&
+               fabs(result - 2) <= tolerances[rule],
+               "%s of sin over [0, pi] = %.17g", rule_names[rule], result);
+    }
+    context.rule = RULE_ADAPTIVE;
+    expect(!core_context_integrate(&context, 0, pi, 0, &result) &&
+           fabs(result - 2) <= 1e-10,
+           "adaptive with chunk 0 = %.17g", result);
+    expect(!core_context_integrate_adaptive(&context, 1, 1, 1e-10, 1e-10,
+                                            ADAPTIVE_LIMIT, &result,
+                                            &error) && result == 0,
+           "adaptive over an empty range = %.17g", result);
+    context.rule = RULE_GAUSS5;
+    expect(!core_context_integrate(&context, 0, pi, 0, &result) &&
+           result == 0, "gauss5 with chunk 0 = %.17g", result);
+    expect(!core_context_integrate(&context, 1, 1, 100, &result) &&
+           result == 0, "gauss5 over an empty range = %.17g", result);
+    expect(core_context_integrate(&context, 1, 0, 100, &result) == 2,
+           "reversed range accepted");
+    load(&context, "x exp");
+    for (int p = PRECISION_DOUBLE; p <= PRECISION_DOUBLE_DOUBLE; ++p) {
+        context.precision = p;
+        context.rule = RULE_GAUSS5;
+        expect(!core_context_integrate(&context, 0, 1, 100, &result) &&
+               fabs(result - (exp(1) - 1)) <=
+               (p == PRECISION_FLOAT ? 1e-5 : 1e-13),
+               "precision %d integral of exp = %.17g", p, result);
+        context.rule = RULE_ADAPTIVE;
+        expect(!core_context_integrate(&context, 0, 1, 0, &result) &&
+               fabs(result - (exp(1) - 1)) <=
+               (p == PRECISION_FLOAT ? 1e-5 : 1e-10),
+               "precision %d adaptive integral of exp = %.17g", p, result);
+    }
+    core_context_finalize(&context);
+}
+
+static void check_derivatives(void) {
+    struct Context context;
+    struct Dual y;
+    double x = 0.7;
+    load(&context, "x sin x *");
+    expect(!core_context_derivative(&context, x, &y) &&
+           close(y.value, x * sin(x), 1e-15) &&
+           close(y.first, sin(x) + x * cos(x), 1e-15) &&
+           close(y.second, 2 * cos(x) - x * sin(x), 1e-15),
+           "derivatives of x sin x = %.17g %.17g %.17g",
+           y.value, y.first, y.second);
+    load(&context, "x exp x 3 ^ +");
+    expect(!core_context_derivative(&context, x, &y) &&
+           close(y.first, exp(x) + 3 * x * x, 1e-15) &&
+           close(y.second, exp(x) + 6 * x, 1e-15),
+           "derivatives of e^x + x^3 = %.17g %.17g", y.first, y.second);
+    core_context_finalize(&context);
+}
+
+static void check_solve(void) {
+    struct Context context;
+    struct Extremum points[16];
+    double roots[16];
+    size_t count;
+    unsigned long evaluations, enclosures;
+    int ret;
+    load(&context, "x cos x -");
+    ret = solve_roots(&context, -10, 10, SOLVE_SCAN, roots, 16, &count,
+                      &evaluations, &enclosures);
+    expect(!ret && count == 1 &&
+           fabs(roots[0] - 0.73908513321516064) <= 1e-12,
+           "root of cos x - x: %zu found, first %.17g", count, roots[0]);
+    load(&context, "x sin");
+    ret = solve_roots(&context, -10, 10, SOLVE_SCAN, roots, 16, &count,
+                      &evaluations, &enclosures);
+    expect(!ret && count == 7, "roots of sin x: %zu found", count);
+    for (size_t i = 0; !ret && i < count && i < 7; ++i) {
+        expect(fabs(roots[i] - (i - 3.0) * pi) <= 1e-12,
+               "root %zu of sin x = %.17g", i, roots[i]);
+    }
+    ret = solve_extrema(&context, 0, 7, SOLVE_SCAN, points, 16, &count,
+                        &evaluations, &enclosures);
+    expect(!ret && count == 2 &&
+           fabs(points[0].x - pi / 2) <= 1e-8 && points[0].maximum &&
+           fabs(points[1].x - 3 * pi / 2) <= 1e-8 && !points[1].maximum,
+           "extrema of sin x over [0, 7]: %zu found", count);
+    load(&context, "x tan");
+    ret = solve_roots(&context, 1, 2, SOLVE_SCAN, roots, 16, &count,
+                      &evaluations, &enclosures);
+    expect(!ret && !count, "tan x has %zu roots across its pole", count);
+    load(&context, "x sin 2 +");
+    ret = solve_roots(&context, -10, 10, SOLVE_SCAN, roots, 16, &count,
+                      &evaluations, &enclosures);
+    expect(!ret && !count && enclosures && evaluations < SOLVE_SCAN,
+           "sin x + 2 pruning: %zu roots, %lu evaluations, %lu enclosures",
+           count, evaluations, enclosures);
+    expect(solve_roots(&context, 1, 1, SOLVE_SCAN, roots, 16, &count,
+                       &evaluations, &enclosures) == 2,
+           "roots over an empty range accepted");
+    core_context_finalize(&context);
+}
+
+static void check_bounds(void) {
+    struct Context context;
+    struct Bounds bounds;
+    double x, y;
+    load(&context, "x sin x 2 ^ *");
+    expect(!core_context_bound(&context, -1, 2, &bounds),
+           "bound of x^2 sin x");
+    for (int i = 0; i <= 1000; ++i) {
+        x = -1 + 3 * i / 1000.0;
+        core_context_evaluate(&context, x, &y);
+        if (!(bounds.lo <= y && y <= bounds.hi)) {
+            expect(0, "x^2 sin x at %g = %g outside [%g, %g]",
+                   x, y, bounds.lo, bounds.hi);
+            break;
+        }
+    }
+    load(&context, "x 2 *");
+    expect(!core_context_bound(&context, 1, 3, &bounds) &&
+           bounds.lo <= 2 && bounds.lo > 1.999 &&
+           bounds.hi >= 6 && bounds.hi < 6.001,
+           "bound of 2x over [1, 3] = [%.17g, %.17g]", bounds.lo, bounds.hi);
+    expect(core_context_bound(&context, 3, 1, &bounds) == 2,
+           "reversed bound accepted");
+    context.precision = PRECISION_FLOAT;
+    expect(core_context_bound(&context, 1, 3, &bounds) == 5,
+           "bound accepted under float");
+    core_context_finalize(&context);
+}
+
+static void check_polynomial(void) {
+    struct Context context;
+    double result, x;
+    load(&context, "x 1 + 3 ^");
+    expect(context.polynomial.degree == 3, "degree of (x+1)^3 = %d",
+           context.polynomial.degree);
+    inputs(-4, 4, 1);
+    core_context_evaluate_batch(&context, xs, ys, POINTS);
+    compare("x 1 + 3 ^", "horner", ys, refs, 1e-13);
+    for (int rule = RULE_TRAPEZOID; rule <= RULE_ADAPTIVE; ++rule) {
+        context.rule = rule;
+        expect(!core_context_integrate(&context, 0, 1, 3, &result) &&
+               fabs(result - 3.75) <= 1e-14,
+               "%s of (x+1)^3 over [0, 1] = %.17g", rule_names[rule], result);
+    }
+    load(&context, "x 1000 - 8 ^");
+    x = 1000.5;
+    core_context_evaluate_batch(&context, &x, &result, 1);
+    expect(close(result, pow(0.5, 8), 1e-12),
+           "(x-1000)^8 at 1000.5 = %.17g", result);
+    core_context_finalize(&context);
+}
+
+static void check_chebyshev(void) {
+    struct Context context;
+    struct Dual y;
+    double result;
+    load(&context, "x exp");
+    expect(!core_context_tabulate(&context, 0, 1),
+           "tabulate exp over [0, 1]");
+    inputs(-1, 2, 1);
+    core_context_evaluate_batch(&context, xs, ys, POINTS);
+    compare("x exp", "tabulated", ys, refs, 1e-12);
+    expect(!core_context_derivative(&context, 0.5, &y) &&
+           close(y.first, exp(0.5), 1e-10) &&
+           close(y.second, exp(0.5), 1e-8),
+           "tabulated derivatives of exp = %.17g %.17g", y.first, y.second);
+    expect(!core_context_integrate(&context, 0.2, 0.8, 10, &result) &&
+           fabs(result - (exp(0.8) - exp(0.2))) <= 1e-12,
+           "tabulated integral of exp = %.17g", result);
+    load(&context, "x log");
+    expect(core_context_tabulate(&context, -1, 1) &&
+           !context.chebyshev.coefficients,
+           "log tabulated across non-finite samples");
+    core_context_finalize(&context);
+}
+
+static void check_edges(void) {
+    struct Context context;
+    double y, x = 1e-3;
+    expect(load(&context, "x +") == 2, "x + compiled");
+    expect(core_context_evaluate(&context, 1, &y) == 2,
+           "x + evaluated");
+    load(&context, "x 1e8 + 1e8 -");
+    context.precision = PRECISION_DOUBLE_DOUBLE;
+    core_context_evaluate_batch(&context, &x, &y, 1);
+    expect(y == x, "double-double x + 1e8 - 1e8 at 1e-3 = %.17g", y);
+    load(&context, "1 x /");
+    for (int m = MATH_STRICT; m <= MATH_FAST; ++m) {
+        context.math = m;
+        core_context_compile(&context, symbols);
+        x = 0;
+        core_context_evaluate(&context, x, &y);
+        expect(y == INFINITY, "tier %d 1/0 = %g", m, y);
+        x = NAN;
+        core_context_evaluate(&context, x, &y);
+        expect(isnan(y), "tier %d 1/nan = %g", m, y);
+    }
+    core_context_finalize(&context);
+}
+
+int main(void) {
+    mkdir(CACHE, 0755);
+    setenv("XDG_CACHE_HOME", CACHE, 1);
+    for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); ++i) {
+        check_paths(paths[i]);
+    }
+    for (size_t i = 0; i < 2; ++i) {
+        check_tier(paths[i], MATH_ULP, PRECISION_DOUBLE, 1e-13);
+        check_tier(paths[i], MATH_FAST, PRECISION_DOUBLE, 1e-9);
+        check_tier(paths[i], MATH_STRICT, PRECISION_FLOAT, 1e-4);
+        check_tier(paths[i], MATH_STRICT, PRECISION_DOUBLE_DOUBLE, 1e-13);
+    }
+    check_rewrites();
+    check_memo();
+    check_integrals();
+    check_derivatives();
+    check_solve();
+    check_bounds();
+    check_polynomial();
+    check_chebyshev();
+    check_edges();
+    printf("%d checks, %d failed\n", checks, failures);
+    return failures != 0;
+}